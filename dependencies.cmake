@@ -7,3 +7,5 @@ FetchContent_Declare(
 )
 
 FetchContent_MakeAvailable(DocTest)
+
+find_package(Threads REQUIRED)
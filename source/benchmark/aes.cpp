@@ -0,0 +1,157 @@
+#include "benchmark.hpp"
+
+#include <understanding_crypto/aes.hpp>
+#include <understanding_crypto/cbc.hpp>
+#include <understanding_crypto/parallel.hpp>
+
+#include <vector>
+
+using namespace understanding_crypto;
+using namespace understanding_crypto::aes;
+
+namespace {
+constexpr size_t block_count = 4096;
+
+template <typename engine_t, typename key_t> void run(std::string_view name) {
+    std::array<uint8_t, key_t::extent> key{};
+    const auto keys = AES::Common::expand_key(key_t{key});
+    std::vector<state_t> blocks(block_count, state_t{0x00112233, 0x44556677, 0x8899aabb, 0xccddeeff});
+
+    const auto encryption = benchmark::measure(block_count * sizeof(state_t), 64, [&] {
+        for (auto &block : blocks) {
+            engine_t::encrypt(block, keys);
+        }
+    });
+    const auto decryption = benchmark::measure(block_count * sizeof(state_t), 64, [&] {
+        for (auto &block : blocks) {
+            engine_t::decrypt(block, keys);
+        }
+    });
+    const auto schedule = AES::Common::expand_key_schedule(key_t{key});
+    const auto equivalent_decryption = benchmark::measure(block_count * sizeof(state_t), 64, [&] {
+        for (auto &block : blocks) {
+            engine_t::decrypt(block, schedule);
+        }
+    });
+    benchmark::report(std::string(name) + " encrypt", encryption);
+    benchmark::report(std::string(name) + " decrypt", decryption);
+    benchmark::report(std::string(name) + " decrypt (inverse keys)", equivalent_decryption);
+}
+
+template <typename key_t> void run_bitsliced(std::string_view name) {
+    std::array<uint8_t, key_t::extent> key{};
+    const auto keys = AES::Bitsliced::slice_keys(AES::Common::expand_key(key_t{key}));
+    std::vector<state_t> blocks(block_count, state_t{0x00112233, 0x44556677, 0x8899aabb, 0xccddeeff});
+
+    const auto encryption = benchmark::measure(block_count * sizeof(state_t), 64,
+                                               [&] { AES::Bitsliced::encrypt(blocks, keys); });
+    const auto decryption = benchmark::measure(block_count * sizeof(state_t), 64,
+                                               [&] { AES::Bitsliced::decrypt(blocks, keys); });
+    benchmark::report(std::string(name) + " encrypt", encryption);
+    benchmark::report(std::string(name) + " decrypt", decryption);
+}
+
+// large buffer, well beyond the caches, for the multi block kernels
+template <AES::Bulk_Engine engine> void run_bulk(std::string_view name) {
+    constexpr size_t bulk_block_count = 1 << 20;
+    std::array<uint8_t, key128_t::extent> key{};
+    const auto keys = AES::Common::expand_key_schedule(key128_t{key});
+    // input byte order, the layout callers actually hold
+    std::vector<uint8_t> bytes(bulk_block_count * sizeof(state_t), 0x5a);
+
+    const auto encryption =
+        benchmark::measure(bytes.size(), 8, [&] { AES::encrypt_blocks<engine>(bytes, keys); });
+    const auto decryption =
+        benchmark::measure(bytes.size(), 8, [&] { AES::decrypt_blocks<engine>(bytes, keys); });
+    benchmark::report(std::string(name) + " encrypt", encryption);
+    benchmark::report(std::string(name) + " decrypt", decryption);
+}
+
+// serial encryption of one stream against interleaved decryption and side by side streams
+void run_cbc() {
+    constexpr size_t stream_count = 8;
+    constexpr size_t stream_size = 1 << 16;
+    std::array<uint8_t, key128_t::extent> key{};
+    const auto keys = AES::Common::expand_key_schedule(key128_t{key});
+    std::vector<uint8_t> bytes(stream_count * stream_size, 0x5a);
+    std::array<std::array<uint8_t, 16>, stream_count> chains{};
+
+    const auto encryption =
+        benchmark::measure(bytes.size(), 8, [&] { CBC{keys, chains[0]}.encrypt(bytes, bytes); });
+    const auto decryption =
+        benchmark::measure(bytes.size(), 8, [&] { CBC{keys, chains[0]}.decrypt(bytes, bytes); });
+    using CBC_t = CBC<key_schedule_t<11>>;
+    std::vector<CBC_t::stream_t> streams;
+    for (auto i = 0U; i < stream_count; ++i) {
+        const auto stream = std::span(bytes).subspan(i * stream_size, stream_size);
+        streams.push_back({chains[i], stream, stream});
+    }
+    const auto streams_encryption =
+        benchmark::measure(bytes.size(), 8, [&] { CBC_t::encrypt_streams(keys, streams); });
+    benchmark::report("cbc-128 encrypt", encryption);
+    benchmark::report("cbc-128 decrypt", decryption);
+    benchmark::report("cbc-128 encrypt 8 streams", streams_encryption);
+}
+
+// the large buffer of run_bulk, split into chunks over the threads
+void run_parallel(size_t threads) {
+    constexpr size_t bulk_block_count = 1 << 20;
+    std::array<uint8_t, key128_t::extent> key{};
+    std::array<uint8_t, 16> iv{};
+    const auto keys = AES::Common::expand_key_schedule(key128_t{key});
+    const GCM gcm{keys};
+    std::vector<uint8_t> bytes(bulk_block_count * sizeof(state_t), 0x5a);
+    std::array<uint8_t, 16> tag;
+
+    Parallel parallel{threads};
+    const auto ecb = benchmark::measure(bytes.size(), 8, [&] { parallel.ecb_encrypt(bytes, keys); });
+    const auto ctr = benchmark::measure(bytes.size(), 8, [&] { parallel.ctr(keys, iv, bytes, bytes); });
+    const auto gcm_encryption = benchmark::measure(bytes.size(), 8, [&] {
+        parallel.gcm_encrypt(gcm, std::span(iv).first<12>(), {}, bytes, bytes, tag);
+    });
+
+    const auto name = "parallel " + std::to_string(threads) + " threads-128";
+    benchmark::report(name + " ecb encrypt", ecb);
+    benchmark::report(name + " ctr", ctr);
+    benchmark::report(name + " gcm encrypt", gcm_encryption);
+}
+
+template <typename engine_t> void run_all_keys(std::string_view name) {
+    run<engine_t, key128_t>(std::string(name) + "-128");
+    run<engine_t, key192_t>(std::string(name) + "-192");
+    run<engine_t, key256_t>(std::string(name) + "-256");
+}
+} // namespace
+
+int main() {
+    run_all_keys<AES::Reference>("reference");
+    run_all_keys<AES::TTable>("t-table");
+    run_bitsliced<key128_t>("bitsliced-128");
+    run_bitsliced<key192_t>("bitsliced-192");
+    run_bitsliced<key256_t>("bitsliced-256");
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (AES::AESNI::supported()) {
+        run_all_keys<AES::AESNI>("aes-ni");
+    }
+#endif
+
+    run_bulk<AES::Bulk_Engine::SOFTWARE>("bulk software-128");
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (AES::AESNI::supported()) {
+        run_bulk<AES::Bulk_Engine::AESNI>("bulk aes-ni-128");
+    }
+    if (AES::VAES256::supported()) {
+        run_bulk<AES::Bulk_Engine::VAES256>("bulk vaes-256-128");
+    }
+    if (AES::VAES512::supported()) {
+        run_bulk<AES::Bulk_Engine::VAES512>("bulk vaes-512-128");
+    }
+#endif
+
+    run_cbc();
+    run_parallel(1);
+    if (Thread_Pool::default_threads() > 1) {
+        run_parallel(Thread_Pool::default_threads());
+    }
+    return 0;
+}
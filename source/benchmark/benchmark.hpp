@@ -0,0 +1,88 @@
+#ifndef UNDERSTANDING_CRYPTO_BENCHMARK_H
+#define UNDERSTANDING_CRYPTO_BENCHMARK_H
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include <understanding_crypto/cpu.hpp>
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+#include <x86intrin.h>
+#endif
+
+namespace understanding_crypto::benchmark {
+struct result_t {
+    double cycles_per_byte;
+    double megabytes_per_second;
+};
+
+struct operations_result_t {
+    double cycles_per_operation;
+    double operations_per_second;
+};
+
+inline uint64_t cycles() {
+#ifdef UNDERSTANDING_CRYPTO_X86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct elapsed_t {
+    double cycles;
+    double seconds;
+};
+
+// runs the function once to warm up, then repetitions times
+template <typename function_t> elapsed_t time_calls(size_t repetitions, function_t &&function) {
+    function();
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto start_cycles = cycles();
+    for (auto i = 0U; i < repetitions; ++i) {
+        function();
+    }
+    const auto stop_cycles = cycles();
+    const auto stop_time = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(stop_time - start_time).count();
+    return {double(stop_cycles - start_cycles), seconds};
+}
+
+// each call processing bytes
+template <typename function_t> result_t measure(size_t bytes, size_t repetitions, function_t &&function) {
+    const auto elapsed = time_calls(repetitions, function);
+    const double total = double(bytes) * repetitions;
+    return {elapsed.cycles / total, total / elapsed.seconds / 1e6};
+}
+
+// each call performing operations, such as one modular exponentiation per job
+template <typename function_t>
+operations_result_t measure_operations(size_t operations, size_t repetitions, function_t &&function) {
+    const auto elapsed = time_calls(repetitions, function);
+    const double total = double(operations) * repetitions;
+    return {elapsed.cycles / total, total / elapsed.seconds};
+}
+
+inline void report(std::string_view name, const result_t &result) {
+    std::printf("%-40.*s %8.2f cycles/byte %10.1f MB/s\n", int(name.size()), name.data(),
+                result.cycles_per_byte, result.megabytes_per_second);
+}
+
+// for aggregate rates over many messages, which pass 1000 MB/s
+inline void report_gigabytes(std::string_view name, const result_t &result) {
+    std::printf("%-40.*s %8.2f cycles/byte %10.2f GB/s\n", int(name.size()), name.data(),
+                result.cycles_per_byte, result.megabytes_per_second / 1e3);
+}
+
+inline void report(std::string_view name, const operations_result_t &result) {
+    std::printf("%-40.*s %12.0f cycles/op %10.1f ops/s\n", int(name.size()), name.data(),
+                result.cycles_per_operation, result.operations_per_second);
+}
+} // namespace understanding_crypto::benchmark
+
+#endif
@@ -0,0 +1,35 @@
+#include "benchmark.hpp"
+
+#include <understanding_crypto/drbg.hpp>
+
+#include <vector>
+
+using namespace understanding_crypto;
+using namespace understanding_crypto::aes;
+
+namespace {
+// the same number of bytes in requests of one size, small ones are served from the buffer
+void run_fill(size_t request_size) {
+    constexpr size_t total = 1 << 22;
+    std::vector<uint8_t> bytes(request_size);
+    const auto result = benchmark::measure(total, 4, [&] {
+        for (size_t done = 0; done < total; done += request_size) {
+            Thread_Random::fill(bytes);
+        }
+    });
+    benchmark::report("thread random fill " + std::to_string(request_size) + " bytes", result);
+}
+} // namespace
+
+int main() {
+    std::array<uint8_t, CTR_DRBG::seed_size> entropy{};
+    CTR_DRBG drbg{entropy};
+    std::vector<uint8_t> bytes(CTR_DRBG::max_request);
+    const auto generate = benchmark::measure(bytes.size(), 256, [&] { drbg.generate(bytes); });
+    benchmark::report("ctr drbg generate 64 KiB", generate);
+
+    for (const auto size : {16U, 32U, 256U, 4096U, 1U << 16}) {
+        run_fill(size);
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "benchmark.hpp"
+
+#include <understanding_crypto/modexp.hpp>
+#include <understanding_crypto/modexp_batch.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace understanding_crypto;
+
+namespace {
+// a random odd modulus of full length and a full length secret exponent, as in RSA signing, against the
+// public exponent 65537
+template <size_t BITS> void run(size_t repetitions) {
+    std::mt19937_64 random(BITS);
+    uint_t<BITS> n, base, exponent;
+    for (size_t i = 0; i < n.word_count; ++i) {
+        n[i] = random();
+        base[i] = random();
+        exponent[i] = random();
+    }
+    n[0] |= 1;
+    n[n.word_count - 1] |= size_t(1) << (n.bits_in_word - 1);
+    base = base % n;
+    const Montgomery<BITS> context{n};
+
+    auto result = base;
+    const auto secret =
+        benchmark::measure_operations(1, repetitions, [&] { result = pow_mod(context, result, exponent); });
+    const auto variable = benchmark::measure_operations(
+        1, repetitions, [&] { result = pow_mod_public(context, result, exponent); });
+    const auto public_exponent = benchmark::measure_operations(1, repetitions * 100, [&] {
+        result = pow_mod_public(context, result, uint_t<32>{65537U});
+    });
+
+    const auto name = "modexp " + std::to_string(BITS);
+    benchmark::report(name + " constant time", secret);
+    benchmark::report(name + " variable time", variable);
+    benchmark::report(name + " e = 65537", public_exponent);
+}
+
+// independent jobs with different moduli and exponents, as in a server signing for many keys: one at a
+// time against pow_mod_batch, which runs them in the SIMD lanes where it can
+template <size_t BITS> void run_batch(size_t repetitions) {
+    constexpr size_t jobs = 8;
+    std::mt19937_64 random(BITS + 1);
+    std::vector<uint_t<BITS>> moduli(jobs), bases(jobs), exponents(jobs), results(jobs);
+    for (size_t job = 0; job < jobs; ++job) {
+        for (size_t i = 0; i < moduli[job].word_count; ++i) {
+            moduli[job][i] = random();
+            bases[job][i] = random();
+            exponents[job][i] = random();
+        }
+        moduli[job][0] |= 1;
+        bases[job] = bases[job] % moduli[job];
+    }
+
+    const auto single = benchmark::measure_operations(jobs, repetitions, [&] {
+        for (size_t job = 0; job < jobs; ++job) {
+            results[job] = pow_mod(bases[job], exponents[job], moduli[job]);
+        }
+    });
+    const auto batch = benchmark::measure_operations(jobs, repetitions, [&] {
+        pow_mod_batch<BITS, BITS>(bases, exponents, moduli, results);
+    });
+
+    const auto name = "modexp " + std::to_string(BITS);
+    benchmark::report(name + " one at a time", single);
+    benchmark::report(name + " batch of " + std::to_string(jobs), batch);
+}
+} // namespace
+
+int main() {
+    run<2048>(20);
+    run<3072>(8);
+    run<4096>(4);
+    run_batch<2048>(4);
+    run_batch<4096>(1);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "benchmark.hpp"
+
+#include <understanding_crypto/sha.hpp>
+
+#include <vector>
+
+using namespace understanding_crypto;
+using namespace understanding_crypto::sha;
+
+namespace {
+constexpr size_t total = 1 << 22;
+
+template <typename engine_t> void run(std::string_view name) {
+    std::vector<uint8_t> bytes(total, 0x5a);
+    state_t state = SHA256::initial_state;
+    const auto result = benchmark::measure(bytes.size(), 8, [&] { engine_t::compress(state, bytes); });
+    benchmark::report(std::string(name) + " compress", result);
+}
+
+// the same bytes as independent messages of one size, one after the other against the lanes. Reported as
+// aggregate GB/s
+void run_messages(size_t message_size) {
+    std::vector<uint8_t> bytes(total, 0x5a);
+    std::vector<std::span<const uint8_t>> messages;
+    for (size_t offset = 0; offset < total; offset += message_size) {
+        messages.push_back(std::span(bytes).subspan(offset, message_size));
+    }
+    std::vector<SHA256::digest_t> digests(messages.size());
+    const auto name = "sha-256 " + std::to_string(message_size) + " byte messages";
+
+    const auto single = benchmark::measure(total, 8, [&] {
+        for (size_t i = 0; i < messages.size(); ++i) {
+            digests[i] = SHA256::hash(messages[i]);
+        }
+    });
+    benchmark::report_gigabytes(name + " one by one", single);
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (AVX2::supported()) {
+        const auto lanes = benchmark::measure(total, 8, [&] { hash_lanes<AVX2>(messages, digests); });
+        benchmark::report_gigabytes(name + " avx2 x8", lanes);
+    }
+    if (AVX512::supported()) {
+        const auto lanes = benchmark::measure(total, 8, [&] { hash_lanes<AVX512>(messages, digests); });
+        benchmark::report_gigabytes(name + " avx-512 x16", lanes);
+    }
+#endif
+    const auto batch = benchmark::measure(total, 8, [&] { hash_batch(messages, digests); });
+    benchmark::report_gigabytes(name + " hash_batch", batch);
+}
+} // namespace
+
+int main() {
+    run<Reference>("reference");
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (SHANI::supported()) {
+        run<SHANI>("sha-ni");
+    }
+#endif
+
+    for (const auto size : {64U, 256U, 1024U, 4096U}) {
+        run_messages(size);
+    }
+    return 0;
+}
@@ -4,85 +4,733 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
+#include <optional>
 #include <span>
 
+#include <understanding_crypto/cpu.hpp>
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+#include <immintrin.h>
+#endif
+
 namespace understanding_crypto::aes {
 using key128_t = std::span<uint8_t, 16>;
 using key192_t = std::span<uint8_t, 24>;
 using key256_t = std::span<uint8_t, 32>;
 
+// one big endian word per column, row 0 in the top byte, round keys use the same layout
 using state_t = std::array<uint32_t, 4>;
+// a block in input byte order
+using block128_t = std::span<uint8_t, 16>;
+
+// the expanded keys together with the round keys of the equivalent inverse cipher (FIPS-197 5.3.5),
+// in the order decryption uses them. Accepted everywhere plain expanded keys are.
+template <size_t ROUNDS> struct key_schedule_t {
+    std::array<state_t, ROUNDS> encryption;
+    std::array<state_t, ROUNDS> decryption;
+};
+
+template <typename expanded_keys_t> constexpr size_t round_key_count = std::tuple_size_v<expanded_keys_t>;
+template <size_t ROUNDS> constexpr size_t round_key_count<key_schedule_t<ROUNDS>> = ROUNDS;
 
 class AES {
+    // keys may also be spans of const bytes, so constant keys can be expanded at compile time
     template <typename KEY_T> consteval static int round_count() {
-        if constexpr (std::is_same_v<KEY_T, key128_t>)
+        using key_t = std::span<uint8_t, KEY_T::extent>;
+        static_assert(std::is_same_v<std::remove_const_t<typename KEY_T::element_type>, uint8_t>,
+                      "invalid key type");
+        if constexpr (std::is_same_v<key_t, key128_t>)
             return 10;
-        else if constexpr (std::is_same_v<KEY_T, key192_t>)
+        else if constexpr (std::is_same_v<key_t, key192_t>)
             return 12;
-        else if constexpr (std::is_same_v<KEY_T, key256_t>)
+        else if constexpr (std::is_same_v<key_t, key256_t>)
             return 14;
         else
-            static_assert(std::is_same_v<KEY_T, key128_t>, "invalid key type");
+            static_assert(std::is_same_v<key_t, key128_t>, "invalid key type");
     }
 
   public:
     template <typename expanded_keys_t> static void encrypt(state_t &data, const expanded_keys_t &keys) {
-        Common::transpose(data);
-        Common::add_round_key(data, keys.front());
-        for (auto i = 1U; i < keys.size() - 1; ++i) {
-            Encryption::substitute_bytes(data);
-            Encryption::row_shift(data);
-            Encryption::mix_columns(data);
-            Common::add_round_key(data, keys[i]);
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (AESNI::supported()) {
+            AESNI::encrypt(data, Common::encryption_keys(keys));
+            return;
         }
-        Encryption::substitute_bytes(data);
-        Encryption::row_shift(data);
-        Common::add_round_key(data, keys.back());
-        Common::transpose(data);
+#endif
+        Reference::encrypt(data, Common::encryption_keys(keys));
     }
 
+    // with a key_schedule_t both paths run the equivalent inverse cipher on the cached decryption keys
     template <typename expanded_keys_t> static void decrypt(state_t &data, const expanded_keys_t &keys) {
-        Common::transpose(data);
-        Common::add_round_key(data, keys.back());
-        Decryption::row_shift(data);
-        Decryption::substitute_bytes(data);
-        for (auto i = keys.size() - 2; i > 0; --i) {
-            Common::add_round_key(data, keys[i]);
-            Decryption::mix_columns(data);
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (AESNI::supported()) {
+            AESNI::decrypt(data, keys);
+            return;
+        }
+#endif
+        Reference::decrypt(data, keys);
+    }
+
+    template <typename expanded_keys_t> static void encrypt(block128_t block, const expanded_keys_t &keys) {
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (AESNI::supported()) {
+            AESNI::encrypt(as_block_bytes(block), Common::encryption_keys(keys));
+            return;
+        }
+#endif
+        auto state = Common::load_block(block);
+        Reference::encrypt(state, Common::encryption_keys(keys));
+        Common::store_block(state, block);
+    }
+
+    template <typename expanded_keys_t> static void decrypt(block128_t block, const expanded_keys_t &keys) {
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (AESNI::supported()) {
+            AESNI::decrypt(as_block_bytes(block), keys);
+            return;
+        }
+#endif
+        auto state = Common::load_block(block);
+        Reference::decrypt(state, keys);
+        Common::store_block(state, block);
+    }
+
+    enum class Bulk_Engine { SOFTWARE, AESNI, VAES256, VAES512 };
+
+    // widest engine the cpu supports, chosen on first use
+    static Bulk_Engine bulk_engine() {
+        static const auto engine = [] {
+#ifdef UNDERSTANDING_CRYPTO_X86
+            if (VAES512::supported())
+                return Bulk_Engine::VAES512;
+            if (VAES256::supported())
+                return Bulk_Engine::VAES256;
+            if (AESNI::supported())
+                return Bulk_Engine::AESNI;
+#endif
+            return Bulk_Engine::SOFTWARE;
+        }();
+        return engine;
+    }
+
+    // bytes holds whole blocks in input byte order, nothing is converted on the hardware paths
+    template <typename expanded_keys_t>
+    static void encrypt_blocks(std::span<uint8_t> bytes, const expanded_keys_t &keys) {
+        process_blocks<true>(as_blocks(bytes), keys);
+    }
+
+    template <typename expanded_keys_t>
+    static void decrypt_blocks(std::span<uint8_t> bytes, const expanded_keys_t &keys) {
+        process_blocks<false>(as_blocks(bytes), keys);
+    }
+
+    template <typename expanded_keys_t>
+    static void encrypt_blocks(std::span<state_t> blocks, const expanded_keys_t &keys) {
+        process_blocks<true>(blocks, keys);
+    }
+
+    template <typename expanded_keys_t>
+    static void decrypt_blocks(std::span<state_t> blocks, const expanded_keys_t &keys) {
+        process_blocks<false>(blocks, keys);
+    }
+
+    template <Bulk_Engine engine, typename expanded_keys_t>
+    static void encrypt_blocks(std::span<uint8_t> bytes, const expanded_keys_t &keys) {
+        process_blocks<true, engine>(as_blocks(bytes), keys);
+    }
+
+    template <Bulk_Engine engine, typename expanded_keys_t>
+    static void decrypt_blocks(std::span<uint8_t> bytes, const expanded_keys_t &keys) {
+        process_blocks<false, engine>(as_blocks(bytes), keys);
+    }
+
+    template <Bulk_Engine engine, typename expanded_keys_t>
+    static void encrypt_blocks(std::span<state_t> blocks, const expanded_keys_t &keys) {
+        process_blocks<true, engine>(blocks, keys);
+    }
+
+    template <Bulk_Engine engine, typename expanded_keys_t>
+    static void decrypt_blocks(std::span<state_t> blocks, const expanded_keys_t &keys) {
+        process_blocks<false, engine>(blocks, keys);
+    }
+
+  private:
+    using block_bytes_t = std::array<uint8_t, 16>;
+
+    static block_bytes_t &as_block_bytes(block128_t block) {
+        return *reinterpret_cast<block_bytes_t *>(block.data());
+    }
+
+    static std::span<block_bytes_t> as_blocks(std::span<uint8_t> bytes) {
+        return {reinterpret_cast<block_bytes_t *>(bytes.data()), bytes.size() / sizeof(block_bytes_t)};
+    }
+
+    template <bool encrypting, typename block_type, typename expanded_keys_t>
+    static void process_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+        switch (bulk_engine()) {
+        case Bulk_Engine::VAES512:
+            return process_blocks<encrypting, Bulk_Engine::VAES512>(blocks, keys);
+        case Bulk_Engine::VAES256:
+            return process_blocks<encrypting, Bulk_Engine::VAES256>(blocks, keys);
+        case Bulk_Engine::AESNI:
+            return process_blocks<encrypting, Bulk_Engine::AESNI>(blocks, keys);
+        case Bulk_Engine::SOFTWARE:
+            return process_blocks<encrypting, Bulk_Engine::SOFTWARE>(blocks, keys);
+        }
+    }
+
+    // the hardware kernels only take whole groups. What the VAES kernels leave goes through the 8 block
+    // AES-NI kernel, the last few blocks through the single block path
+    template <bool encrypting, Bulk_Engine engine, typename block_type, typename keys_t>
+    static void process_blocks(std::span<block_type> blocks, const keys_t &bulk_keys) {
+        if constexpr (engine == Bulk_Engine::SOFTWARE) {
+            process_bitsliced<encrypting>(blocks, bulk_keys);
+        } else {
+            const auto &keys = plain_keys(bulk_keys);
+            size_t done = 0;
+#ifdef UNDERSTANDING_CRYPTO_X86
+            const auto &encryption_keys = Common::encryption_keys(keys);
+            if constexpr (engine == Bulk_Engine::VAES256) {
+                done = encrypting ? VAES256::encrypt_blocks(blocks, encryption_keys)
+                                  : VAES256::decrypt_blocks(blocks, keys);
+            } else if constexpr (engine == Bulk_Engine::VAES512) {
+                done = encrypting ? VAES512::encrypt_blocks(blocks, encryption_keys)
+                                  : VAES512::decrypt_blocks(blocks, keys);
+            }
+            const auto rest = blocks.subspan(done);
+            done += encrypting ? AESNI::encrypt_blocks(rest, encryption_keys)
+                               : AESNI::decrypt_blocks(rest, keys);
+#endif
+            for (auto &block : blocks.subspan(done)) {
+                encrypting ? encrypt(block, keys) : decrypt(block, keys);
+            }
+        }
+    }
+
+    template <typename keys_t>
+    static constexpr bool is_bulk_keys = requires { typename keys_t::sliced_keys_t; };
+
+    // the expanded keys inside a Bulk_Keys, other keys as they are
+    template <typename keys_t> static const auto &plain_keys(const keys_t &keys) {
+        if constexpr (is_bulk_keys<keys_t>) {
+            return keys.keys;
+        } else {
+            return keys;
+        }
+    }
+
+    // keys sliced by a Bulk_Keys are used as they are, other keys are sliced for this call
+    template <bool encrypting, typename block_type, typename keys_t>
+    static void process_bitsliced(std::span<block_type> blocks, const keys_t &keys) {
+        if constexpr (is_bulk_keys<keys_t>) {
+            if (keys.sliced) {
+                process_sliced<encrypting>(blocks, *keys.sliced);
+                return;
+            }
+        }
+        process_sliced<encrypting>(blocks, Bitsliced::slice_keys(Common::encryption_keys(plain_keys(keys))));
+    }
+
+    // the bitsliced planes are packed from words, bytes are converted one group at a time
+    template <bool encrypting, typename block_type, typename sliced_keys_t>
+    static void process_sliced(std::span<block_type> blocks, const sliced_keys_t &sliced_keys) {
+        for (size_t offset = 0; offset < blocks.size(); offset += Bitsliced::block_count) {
+            const auto count = std::min(Bitsliced::block_count, blocks.size() - offset);
+            const auto group = blocks.subspan(offset, count);
+            std::array<state_t, Bitsliced::block_count> buffer;
+            auto states = std::span(buffer).first(group.size());
+            if constexpr (std::is_same_v<block_type, state_t>) {
+                states = group;
+            } else {
+                std::transform(group.begin(), group.end(), states.begin(), Common::load_block);
+            }
+
+            encrypting ? Bitsliced::encrypt(states, sliced_keys) : Bitsliced::decrypt(states, sliced_keys);
+
+            if constexpr (!std::is_same_v<block_type, state_t>) {
+                for (auto i = 0U; i < group.size(); ++i) {
+                    Common::store_block(states[i], group[i]);
+                }
+            }
+        }
+    }
+
+  public:
+    struct Reference {
+        template <typename expanded_keys_t> static void encrypt(state_t &data, const expanded_keys_t &keys) {
+            Common::add_round_key(data, keys.front());
+            for (auto i = 1U; i < keys.size() - 1; ++i) {
+                Encryption::substitute_bytes(data);
+                Encryption::row_shift(data);
+                Encryption::mix_columns(data);
+                Common::add_round_key(data, keys[i]);
+            }
+            Encryption::substitute_bytes(data);
+            Encryption::row_shift(data);
+            Common::add_round_key(data, keys.back());
+        }
+
+        template <typename expanded_keys_t> static void decrypt(state_t &data, const expanded_keys_t &keys) {
+            Common::add_round_key(data, keys.back());
             Decryption::row_shift(data);
             Decryption::substitute_bytes(data);
+            for (auto i = keys.size() - 2; i > 0; --i) {
+                Common::add_round_key(data, keys[i]);
+                Decryption::mix_columns(data);
+                Decryption::row_shift(data);
+                Decryption::substitute_bytes(data);
+            }
+            Common::add_round_key(data, keys.front());
+        }
+
+        // equivalent inverse cipher, the same round shape as encryption
+        template <size_t ROUNDS> static void decrypt(state_t &data, const key_schedule_t<ROUNDS> &schedule) {
+            const auto &keys = schedule.decryption;
+            Common::add_round_key(data, keys.front());
+            for (auto i = 1U; i < keys.size() - 1; ++i) {
+                Decryption::substitute_bytes(data);
+                Decryption::row_shift(data);
+                Decryption::mix_columns(data);
+                Common::add_round_key(data, keys[i]);
+            }
+            Decryption::substitute_bytes(data);
+            Decryption::row_shift(data);
+            Common::add_round_key(data, keys.back());
+        }
+    };
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+    struct AESNI {
+        static bool supported() {
+            const auto &features = cpu::features();
+            return features.aes && features.ssse3;
         }
-        Common::add_round_key(data, keys.front());
-        Common::transpose(data);
-    }
+
+        // block_type is state_t or the input bytes. The round count is part of the key type, so the round
+        // loops here and in the kernels below unroll completely
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("aes,ssse3")]] static void encrypt(block_type &data, const expanded_keys_t &keys) {
+            auto block = load_state(data);
+            block = _mm_xor_si128(block, load_state(keys.front()));
+#pragma GCC unroll 16
+            for (auto i = 1U; i < keys.size() - 1; ++i) {
+                block = _mm_aesenc_si128(block, load_state(keys[i]));
+            }
+            block = _mm_aesenclast_si128(block, load_state(keys.back()));
+            store_state(data, block);
+        }
+
+        // AESDEC implements the equivalent inverse cipher, the middle round keys need InvMixColumns
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("aes,ssse3")]] static void decrypt(block_type &data, const expanded_keys_t &keys) {
+            constexpr auto rounds = round_key_count<expanded_keys_t>;
+            auto block = _mm_xor_si128(load_state(data), decryption_round_key(keys, 0));
+#pragma GCC unroll 16
+            for (auto i = 1U; i < rounds - 1; ++i) {
+                block = _mm_aesdec_si128(block, decryption_round_key(keys, i));
+            }
+            block = _mm_aesdeclast_si128(block, decryption_round_key(keys, rounds - 1));
+            store_state(data, block);
+        }
+
+        // round key i of the equivalent inverse cipher, plain expanded keys get InvMixColumns on every load
+        template <size_t ROUNDS>
+        [[gnu::target("aes,ssse3")]]
+        static __m128i decryption_round_key(const std::array<state_t, ROUNDS> &keys, size_t i) {
+            const auto key = load_state(keys[ROUNDS - 1 - i]);
+            return i == 0 || i == ROUNDS - 1 ? key : _mm_aesimc_si128(key);
+        }
+
+        template <size_t ROUNDS>
+        [[gnu::target("ssse3")]]
+        static __m128i decryption_round_key(const key_schedule_t<ROUNDS> &schedule, size_t i) {
+            return load_state(schedule.decryption[i]);
+        }
+
+        // key expansion for four keys at a time, lane k of words[i] holds word i of key k. The recurrence of
+        // Common::expand_key runs once for all four, so its latency is shared. Returns the number of keys
+        // expanded, a multiple of four
+        template <size_t ROUNDS, typename key_t, size_t COUNT>
+        [[gnu::target("aes,ssse3")]]
+        static size_t expand_keys(const std::array<key_t, COUNT> &keys,
+                                  std::array<std::array<state_t, ROUNDS>, COUNT> &expanded) {
+            constexpr auto N = key_t::extent / sizeof(uint32_t);
+            const auto swap_words = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+            size_t first = 0;
+            for (; first + 4 <= COUNT; first += 4) {
+                __m128i words[ROUNDS * 4];
+                // the key bytes are big endian words, a 192 bit key ends with a half register
+                for (auto j = 0U; j < N; j += 4) {
+                    __m128i lanes[4];
+                    for (auto k = 0U; k < 4; ++k) {
+                        const auto address = reinterpret_cast<const __m128i *>(&keys[first + k][4 * j]);
+                        const auto bytes = N - j >= 4 ? _mm_loadu_si128(address) : _mm_loadl_epi64(address);
+                        lanes[k] = _mm_shuffle_epi8(bytes, swap_words);
+                    }
+                    transpose(lanes);
+                    for (auto w = 0U; w < std::min<size_t>(4, N - j); ++w) {
+                        words[j + w] = lanes[w];
+                    }
+                }
+
+                uint32_t round_key = 0x01000000;
+#pragma GCC unroll 64
+                for (auto i = N; i < ROUNDS * 4; ++i) {
+                    auto word = words[i - 1];
+                    if ((i % N) == 0) {
+                        word = _mm_or_si128(_mm_slli_epi32(word, 8), _mm_srli_epi32(word, 24));
+                        word = _mm_xor_si128(substitute_lanes(word), _mm_set1_epi32(round_key));
+                        round_key = GF_MULTIPLY_SIMDx2(round_key);
+                    } else if ((N > 6) && ((i % N) == 4)) {
+                        word = substitute_lanes(word);
+                    }
+                    words[i] = _mm_xor_si128(words[i - N], word);
+                }
+
+                for (auto round = 0U; round < ROUNDS; ++round) {
+                    __m128i lanes[4] = {words[4 * round], words[4 * round + 1], words[4 * round + 2],
+                                        words[4 * round + 3]};
+                    transpose(lanes);
+                    for (auto k = 0U; k < 4; ++k) {
+                        const auto address = reinterpret_cast<__m128i *>(expanded[first + k][round].data());
+                        _mm_storeu_si128(address, lanes[k]);
+                    }
+                }
+            }
+            return first;
+        }
+
+        // Common::decryption_keys with AESIMC for InvMixColumns
+        template <size_t ROUNDS>
+        [[gnu::target("aes,ssse3")]]
+        static std::array<state_t, ROUNDS> decryption_keys(const std::array<state_t, ROUNDS> &keys) {
+            std::array<state_t, ROUNDS> result;
+            result.front() = keys.back();
+            result.back() = keys.front();
+            for (auto i = 1U; i < ROUNDS - 1; ++i) {
+                store_state(result[i], _mm_aesimc_si128(load_state(keys[ROUNDS - 1 - i])));
+            }
+            return result;
+        }
+
+        // SubBytes on every byte. AESENCLAST shifts the rows first, the shuffle moves every byte to the
+        // position ShiftRows takes it from
+        [[gnu::target("aes,ssse3")]] static __m128i substitute_lanes(__m128i x) {
+            const auto inverse_shift_rows =
+                _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3);
+            return _mm_aesenclast_si128(_mm_shuffle_epi8(x, inverse_shift_rows), _mm_setzero_si128());
+        }
+
+        // 4x4 matrix of words, one row per register
+        [[gnu::target("sse2")]] static void transpose(__m128i (&rows)[4]) {
+            const auto low01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+            const auto low23 = _mm_unpacklo_epi32(rows[2], rows[3]);
+            const auto high01 = _mm_unpackhi_epi32(rows[0], rows[1]);
+            const auto high23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+            rows[0] = _mm_unpacklo_epi64(low01, low23);
+            rows[1] = _mm_unpackhi_epi64(low01, low23);
+            rows[2] = _mm_unpacklo_epi64(high01, high23);
+            rows[3] = _mm_unpackhi_epi64(high01, high23);
+        }
+
+        static constexpr size_t interleave = 8;
+
+        // returns the number of blocks processed, always a multiple of interleave
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("aes,ssse3")]]
+        static size_t encrypt_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+            constexpr auto rounds = std::tuple_size_v<expanded_keys_t>;
+            __m128i round_keys[rounds];
+            for (auto i = 0U; i < rounds; ++i) {
+                round_keys[i] = load_state(keys[i]);
+            }
+
+            size_t offset = 0;
+            for (; offset + interleave <= blocks.size(); offset += interleave) {
+                __m128i x[interleave];
+                for (auto j = 0U; j < interleave; ++j) {
+                    x[j] = _mm_xor_si128(load_state(blocks[offset + j]), round_keys[0]);
+                }
+#pragma GCC unroll 16
+                for (auto i = 1U; i < rounds - 1; ++i) {
+                    for (auto &block : x) {
+                        block = _mm_aesenc_si128(block, round_keys[i]);
+                    }
+                }
+                for (auto j = 0U; j < interleave; ++j) {
+                    store_state(blocks[offset + j], _mm_aesenclast_si128(x[j], round_keys[rounds - 1]));
+                }
+            }
+            return offset;
+        }
+
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("aes,ssse3")]]
+        static size_t decrypt_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+            constexpr auto rounds = round_key_count<expanded_keys_t>;
+            __m128i round_keys[rounds];
+            for (auto i = 0U; i < rounds; ++i) {
+                round_keys[i] = decryption_round_key(keys, i);
+            }
+
+            size_t offset = 0;
+            for (; offset + interleave <= blocks.size(); offset += interleave) {
+                __m128i x[interleave];
+                for (auto j = 0U; j < interleave; ++j) {
+                    x[j] = _mm_xor_si128(load_state(blocks[offset + j]), round_keys[0]);
+                }
+#pragma GCC unroll 16
+                for (auto i = 1U; i < rounds - 1; ++i) {
+                    for (auto &block : x) {
+                        block = _mm_aesdec_si128(block, round_keys[i]);
+                    }
+                }
+                for (auto j = 0U; j < interleave; ++j) {
+                    store_state(blocks[offset + j], _mm_aesdeclast_si128(x[j], round_keys[rounds - 1]));
+                }
+            }
+            return offset;
+        }
+
+        // state_t holds big endian columns, the instructions expect the bytes in input order
+        [[gnu::target("ssse3")]] static __m128i load_state(const state_t &state) {
+            const auto swap_words = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state.data())),
+                                    swap_words);
+        }
+
+        [[gnu::target("ssse3")]] static void store_state(state_t &state, __m128i block) {
+            const auto swap_words = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(state.data()), _mm_shuffle_epi8(block, swap_words));
+        }
+
+        [[gnu::target("sse2")]] static __m128i load_state(const block_bytes_t &bytes) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes.data()));
+        }
+
+        [[gnu::target("sse2")]] static void store_state(block_bytes_t &bytes, __m128i block) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes.data()), block);
+        }
+    };
+
+    // VAES runs the AES round on every 128 bit lane of a ymm register, two blocks per instruction
+    struct VAES256 {
+        static bool supported() {
+            const auto &features = cpu::features();
+            return features.vaes && features.avx2 && AESNI::supported();
+        }
+
+        static constexpr size_t interleave = 16;
+        static constexpr size_t blocks_per_register = 2;
+
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("vaes,aes,avx2")]]
+        static size_t encrypt_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+            constexpr auto rounds = std::tuple_size_v<expanded_keys_t>;
+            __m256i round_keys[rounds];
+            for (auto i = 0U; i < rounds; ++i) {
+                round_keys[i] = _mm256_broadcastsi128_si256(AESNI::load_state(keys[i]));
+            }
+
+            size_t offset = 0;
+            for (; offset + interleave <= blocks.size(); offset += interleave) {
+                __m256i x[interleave / blocks_per_register];
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    x[j] = load_states(&blocks[offset + blocks_per_register * j]);
+                    x[j] = _mm256_xor_si256(x[j], round_keys[0]);
+                }
+#pragma GCC unroll 16
+                for (auto i = 1U; i < rounds - 1; ++i) {
+                    for (auto &block : x) {
+                        block = _mm256_aesenc_epi128(block, round_keys[i]);
+                    }
+                }
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    store_states(&blocks[offset + blocks_per_register * j],
+                                 _mm256_aesenclast_epi128(x[j], round_keys[rounds - 1]));
+                }
+            }
+            return offset;
+        }
+
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("vaes,aes,avx2")]]
+        static size_t decrypt_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+            constexpr auto rounds = round_key_count<expanded_keys_t>;
+            __m256i round_keys[rounds];
+            for (auto i = 0U; i < rounds; ++i) {
+                round_keys[i] = _mm256_broadcastsi128_si256(AESNI::decryption_round_key(keys, i));
+            }
+
+            size_t offset = 0;
+            for (; offset + interleave <= blocks.size(); offset += interleave) {
+                __m256i x[interleave / blocks_per_register];
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    x[j] = load_states(&blocks[offset + blocks_per_register * j]);
+                    x[j] = _mm256_xor_si256(x[j], round_keys[0]);
+                }
+#pragma GCC unroll 16
+                for (auto i = 1U; i < rounds - 1; ++i) {
+                    for (auto &block : x) {
+                        block = _mm256_aesdec_epi128(block, round_keys[i]);
+                    }
+                }
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    store_states(&blocks[offset + blocks_per_register * j],
+                                 _mm256_aesdeclast_epi128(x[j], round_keys[rounds - 1]));
+                }
+            }
+            return offset;
+        }
+
+        // only state_t needs its words swapped, bytes are loaded as they are
+        template <typename block_type>
+        [[gnu::target("avx2")]] static __m256i load_states(const block_type *states) {
+            const auto blocks = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states));
+            if constexpr (std::is_same_v<block_type, state_t>) {
+                return _mm256_shuffle_epi8(blocks, swap_words());
+            }
+            return blocks;
+        }
+
+        template <typename block_type>
+        [[gnu::target("avx2")]] static void store_states(block_type *states, __m256i blocks) {
+            if constexpr (std::is_same_v<block_type, state_t>) {
+                blocks = _mm256_shuffle_epi8(blocks, swap_words());
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(states), blocks);
+        }
+
+        [[gnu::target("avx2")]] static __m256i swap_words() {
+            return _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, //
+                                    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        }
+    };
+
+    // four blocks per zmm register
+    struct VAES512 {
+        static bool supported() {
+            const auto &features = cpu::features();
+            return features.vaes && features.avx512f && features.avx512bw && AESNI::supported();
+        }
+
+        static constexpr size_t interleave = 16;
+        static constexpr size_t blocks_per_register = 4;
+
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("vaes,aes,avx512f,avx512bw")]]
+        static size_t encrypt_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+            constexpr auto rounds = std::tuple_size_v<expanded_keys_t>;
+            __m512i round_keys[rounds];
+            for (auto i = 0U; i < rounds; ++i) {
+                round_keys[i] = broadcast(AESNI::load_state(keys[i]));
+            }
+
+            size_t offset = 0;
+            for (; offset + interleave <= blocks.size(); offset += interleave) {
+                __m512i x[interleave / blocks_per_register];
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    x[j] = load_states(&blocks[offset + blocks_per_register * j]);
+                    x[j] = _mm512_xor_si512(x[j], round_keys[0]);
+                }
+#pragma GCC unroll 16
+                for (auto i = 1U; i < rounds - 1; ++i) {
+                    for (auto &block : x) {
+                        block = _mm512_aesenc_epi128(block, round_keys[i]);
+                    }
+                }
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    store_states(&blocks[offset + blocks_per_register * j],
+                                 _mm512_aesenclast_epi128(x[j], round_keys[rounds - 1]));
+                }
+            }
+            return offset;
+        }
+
+        template <typename block_type, typename expanded_keys_t>
+        [[gnu::target("vaes,aes,avx512f,avx512bw")]]
+        static size_t decrypt_blocks(std::span<block_type> blocks, const expanded_keys_t &keys) {
+            constexpr auto rounds = round_key_count<expanded_keys_t>;
+            __m512i round_keys[rounds];
+            for (auto i = 0U; i < rounds; ++i) {
+                round_keys[i] = broadcast(AESNI::decryption_round_key(keys, i));
+            }
+
+            size_t offset = 0;
+            for (; offset + interleave <= blocks.size(); offset += interleave) {
+                __m512i x[interleave / blocks_per_register];
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    x[j] = load_states(&blocks[offset + blocks_per_register * j]);
+                    x[j] = _mm512_xor_si512(x[j], round_keys[0]);
+                }
+#pragma GCC unroll 16
+                for (auto i = 1U; i < rounds - 1; ++i) {
+                    for (auto &block : x) {
+                        block = _mm512_aesdec_epi128(block, round_keys[i]);
+                    }
+                }
+                for (auto j = 0U; j < std::size(x); ++j) {
+                    store_states(&blocks[offset + blocks_per_register * j],
+                                 _mm512_aesdeclast_epi128(x[j], round_keys[rounds - 1]));
+                }
+            }
+            return offset;
+        }
+
+        // same as _mm512_broadcast_i32x4, which trips -Wuninitialized with the GCC 12 intrinsic headers
+        [[gnu::target("avx512f")]] static __m512i broadcast(__m128i lane) {
+            return _mm512_maskz_broadcast_i32x4(__mmask16(0xFFFF), lane);
+        }
+
+        template <typename block_type>
+        [[gnu::target("avx512f,avx512bw")]] static __m512i load_states(const block_type *states) {
+            const auto blocks = _mm512_loadu_si512(states);
+            if constexpr (std::is_same_v<block_type, state_t>) {
+                return _mm512_shuffle_epi8(blocks, swap_words());
+            }
+            return blocks;
+        }
+
+        template <typename block_type>
+        [[gnu::target("avx512f,avx512bw")]] static void store_states(block_type *states, __m512i blocks) {
+            if constexpr (std::is_same_v<block_type, state_t>) {
+                blocks = _mm512_shuffle_epi8(blocks, swap_words());
+            }
+            _mm512_storeu_si512(states, blocks);
+        }
+
+        [[gnu::target("avx512f")]] static __m512i swap_words() {
+            return broadcast(_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+        }
+    };
+#endif
 
   public:
     struct Encryption {
+        // row i of column c comes from column c + i
         static state_t &row_shift(state_t &state) {
-            for (auto i = 1U; i < state.size(); ++i) {
-                state[i] = (state[i] << (8 * i)) | (state[i] >> (32 - (8 * i)));
+            const auto copy = state;
+            for (auto i = 0U; i < state.size(); ++i) {
+                state[i] = (copy[i] & 0xFF000000) | (copy[(i + 1) % 4] & 0x00FF0000) |
+                           (copy[(i + 2) % 4] & 0x0000FF00) | (copy[(i + 3) % 4] & 0x000000FF);
             }
             return state;
         }
 
-        static state_t &mix_columns(state_t &x1) {
-            state_t x2;
-            uint32_t all_x1 = 0;
-            for (int i = 0; i < x1.size(); ++i) {
-                all_x1 ^= x1[i];
-                x2[i] = GF_MULTIPLY_SIMDx2(x1[i]);
+        // [0]*0x2 [1]*0x3 [2]*0x1 [3]*0x1, rotating a column left by one byte moves row i + 1 into row i
+        static constexpr state_t &mix_columns(state_t &state) {
+            for (auto &column : state) {
+                const auto next = std::rotl(column, 8);
+                const auto rest = std::rotl(column, 16) ^ std::rotl(column, 24);
+                column = GF_MULTIPLY_SIMDx2(column ^ next) ^ next ^ rest;
             }
-
-            // [0]*0x2 [1]*0x3 [2]*0x1 [3]*0x1
-            x1[0] = all_x1 ^ x1[0] ^ x2[0] ^ x2[1];
-            x1[1] = all_x1 ^ x1[1] ^ x2[1] ^ x2[2];
-            x1[2] = all_x1 ^ x1[2] ^ x2[2] ^ x2[3];
-            x1[3] = all_x1 ^ x1[3] ^ x2[3] ^ x2[0];
-            return x1;
+            return state;
         }
 
-        static uint32_t substitute_word(uint32_t word) {
+        static constexpr uint32_t substitute_word(uint32_t word) {
             uint32_t result = 0;
             for (ssize_t i = 24; i >= 0; i -= 8) {
                 result <<= 8;
@@ -118,35 +766,26 @@ class AES {
     };
 
     struct Decryption {
+        // row i of column c comes from column c - i
         static state_t &row_shift(state_t &state) {
-            for (auto i = 1U; i < state.size(); ++i) {
-                state[i] = (state[i] >> (8 * i)) | (state[i] << (32 - 8 * i));
+            const auto copy = state;
+            for (auto i = 0U; i < state.size(); ++i) {
+                state[i] = (copy[i] & 0xFF000000) | (copy[(i + 3) % 4] & 0x00FF0000) |
+                           (copy[(i + 2) % 4] & 0x0000FF00) | (copy[(i + 1) % 4] & 0x000000FF);
             }
             return state;
         }
 
-        static state_t &mix_columns(state_t &x1) {
-            state_t x2;
-            state_t x4;
-            state_t x6;
-            uint32_t all_x9 = 0;
-            for (int i = 0; i < x1.size(); ++i) {
-                all_x9 ^= x1[i];
-                x2[i] = GF_MULTIPLY_SIMDx2(x1[i]);
-                x4[i] = GF_MULTIPLY_SIMDx2(x2[i]);
-                x6[i] = x2[i] ^ x4[i];
-                all_x9 ^= GF_MULTIPLY_SIMDx2(x4[i]);
+        // [0]*0xE [1]*0xB [2]*0xD [3]*0x9 factors into [0]*0x5 [2]*0x4 followed by the forward mix
+        static constexpr state_t &mix_columns(state_t &state) {
+            for (auto &column : state) {
+                const auto x4 = GF_MULTIPLY_SIMDx2(GF_MULTIPLY_SIMDx2(column ^ std::rotl(column, 16)));
+                column ^= x4;
             }
-
-            // [0]*0xE [1]*0xB [2]*0xD [3]*0x9
-            x1[0] = all_x9 ^ x1[0] ^ x6[0] ^ x2[1] ^ x4[2];
-            x1[1] = all_x9 ^ x1[1] ^ x6[1] ^ x2[2] ^ x4[3];
-            x1[2] = all_x9 ^ x1[2] ^ x6[2] ^ x2[3] ^ x4[0];
-            x1[3] = all_x9 ^ x1[3] ^ x6[3] ^ x2[0] ^ x4[1];
-            return x1;
+            return Encryption::mix_columns(state);
         }
 
-        static uint32_t substitute_word(uint32_t word) {
+        static constexpr uint32_t substitute_word(uint32_t word) {
             uint32_t result = 0;
             for (ssize_t i = 24; i >= 0; i -= 8) {
                 result <<= 8;
@@ -189,20 +828,61 @@ class AES {
             return state;
         }
 
-        template <typename key_t> static auto expand_key(const key_t &key) {
+        static state_t load_block(std::span<const uint8_t, 16> bytes) {
+            state_t state;
+            for (auto i = 0U; i < state.size(); ++i) {
+                state[i] = (uint32_t(bytes[4 * i]) << 24) | (uint32_t(bytes[4 * i + 1]) << 16) |
+                           (uint32_t(bytes[4 * i + 2]) << 8) | uint32_t(bytes[4 * i + 3]);
+            }
+            return state;
+        }
+
+        static void store_block(const state_t &state, std::span<uint8_t, 16> bytes) {
+            for (auto i = 0U; i < state.size(); ++i) {
+                bytes[4 * i] = state[i] >> 24;
+                bytes[4 * i + 1] = state[i] >> 16;
+                bytes[4 * i + 2] = state[i] >> 8;
+                bytes[4 * i + 3] = state[i];
+            }
+        }
+
+        template <size_t ROUNDS>
+        static const std::array<state_t, ROUNDS> &encryption_keys(const std::array<state_t, ROUNDS> &keys) {
+            return keys;
+        }
+
+        template <size_t ROUNDS>
+        static const std::array<state_t, ROUNDS> &encryption_keys(const key_schedule_t<ROUNDS> &schedule) {
+            return schedule.encryption;
+        }
+
+        // reversed, with InvMixColumns applied to every key but the first and the last
+        template <size_t ROUNDS>
+        static constexpr auto decryption_keys(const std::array<state_t, ROUNDS> &keys) {
+            std::array<state_t, ROUNDS> result{};
+            std::reverse_copy(keys.begin(), keys.end(), result.begin());
+            for (auto i = 1U; i < result.size() - 1; ++i) {
+                Decryption::mix_columns(result[i]);
+            }
+            return result;
+        }
+
+        template <typename key_t> static constexpr auto expand_key_schedule(const key_t &key) {
+            const auto encryption = expand_key(key);
+            return key_schedule_t<round_count<key_t>() + 1>{encryption, decryption_keys(encryption)};
+        }
+
+        template <typename key_t> static constexpr auto expand_key(const key_t &key) {
             constexpr auto ROUNDS = round_count<key_t>() + 1;
-            using expanded_keys_t = std::array<state_t, ROUNDS>;
-            expanded_keys_t expanded{};
-            auto &linear_view =
-                *reinterpret_cast<std::array<uint32_t, ROUNDS * sizeof(uint32_t)> *>(&expanded);
             constexpr auto N = key_t::extent / sizeof(uint32_t);
+            std::array<uint32_t, ROUNDS * sizeof(uint32_t)> linear_view{};
 
             for (auto i = 0U; i < key.size(); ++i) {
                 linear_view[i / sizeof(uint32_t)] <<= 8;
                 linear_view[i / sizeof(uint32_t)] |= key[i];
             }
 
-            auto round_key = 0x01000000;
+            uint32_t round_key = 0x01000000;
             for (auto i = N; i < linear_view.size(); ++i) {
                 auto tmp = linear_view[i - 1];
                 if ((i % N) == 0) {
@@ -215,25 +895,452 @@ class AES {
                 linear_view[i] = linear_view[i - N] ^ tmp;
             }
 
-            for (auto &key : expanded) {
-                transpose(key);
+            std::array<state_t, ROUNDS> expanded{};
+            for (auto i = 0U; i < linear_view.size(); ++i) {
+                expanded[i / 4][i % 4] = linear_view[i];
             }
             return expanded;
         }
 
-        static state_t &transpose(state_t &state) {
-            const auto copy = state;
+        // COUNT independent keys of one size, with AES-NI four of them share one pass of the recurrence. The
+        // result is contiguous, one expanded key after the other
+        template <typename key_t, size_t COUNT>
+        static auto expand_keys(const std::array<key_t, COUNT> &keys) {
+            constexpr auto ROUNDS = round_count<key_t>() + 1;
+            std::array<std::array<state_t, ROUNDS>, COUNT> expanded;
+            size_t done = 0;
+#ifdef UNDERSTANDING_CRYPTO_X86
+            if (AESNI::supported()) {
+                done = AESNI::expand_keys(keys, expanded);
+            }
+#endif
+            for (auto k = done; k < COUNT; ++k) {
+                expanded[k] = expand_key(keys[k]);
+            }
+            return expanded;
+        }
+
+        template <typename key_t, size_t COUNT>
+        static auto expand_key_schedules(const std::array<key_t, COUNT> &keys) {
+            constexpr auto ROUNDS = round_count<key_t>() + 1;
+            const auto expanded = expand_keys(keys);
+            std::array<key_schedule_t<ROUNDS>, COUNT> schedules;
+            for (auto k = 0U; k < COUNT; ++k) {
+                schedules[k].encryption = expanded[k];
+#ifdef UNDERSTANDING_CRYPTO_X86
+                if (AESNI::supported()) {
+                    schedules[k].decryption = AESNI::decryption_keys(expanded[k]);
+                    continue;
+                }
+#endif
+                schedules[k].decryption = decryption_keys(expanded[k]);
+            }
+            return schedules;
+        }
+    };
+
+    // one table lookup per byte does sub bytes and mix columns at once, row shift selects the source columns
+    struct TTable {
+        template <typename expanded_keys_t> static void encrypt(state_t &data, const expanded_keys_t &keys) {
+            Common::add_round_key(data, keys.front());
+#pragma GCC unroll 16
+            for (auto i = 1U; i < keys.size() - 1; ++i) {
+                data = encryption_round(data);
+                Common::add_round_key(data, keys[i]);
+            }
+            data = encryption_final_round(data);
+            Common::add_round_key(data, keys.back());
+        }
+
+        // for a single block: the round keys are mixed on the fly, blocks in bulk go through the span
+        // overload, which converts the keys once
+        template <typename expanded_keys_t> static void decrypt(state_t &data, const expanded_keys_t &keys) {
+            Common::add_round_key(data, keys.back());
+#pragma GCC unroll 16
+            for (auto i = keys.size() - 2; i > 0; --i) {
+                data = decryption_round(data);
+                // the equivalent inverse cipher needs the mixed round key
+                auto key = keys[i];
+                Common::add_round_key(data, Decryption::mix_columns(key));
+            }
+            data = decryption_final_round(data);
+            Common::add_round_key(data, keys.front());
+        }
+
+        template <size_t ROUNDS> static void decrypt(state_t &data, const key_schedule_t<ROUNDS> &schedule) {
+            const auto &keys = schedule.decryption;
+            Common::add_round_key(data, keys.front());
+#pragma GCC unroll 16
+            for (auto i = 1U; i < keys.size() - 1; ++i) {
+                data = decryption_round(data);
+                Common::add_round_key(data, keys[i]);
+            }
+            data = decryption_final_round(data);
+            Common::add_round_key(data, keys.back());
+        }
+
+        template <typename expanded_keys_t>
+        static void encrypt(std::span<state_t> blocks, const expanded_keys_t &keys) {
+            for (auto &block : blocks) {
+                encrypt(block, Common::encryption_keys(keys));
+            }
+        }
+
+        template <size_t ROUNDS>
+        static void decrypt(std::span<state_t> blocks, const key_schedule_t<ROUNDS> &schedule) {
+            for (auto &block : blocks) {
+                decrypt(block, schedule);
+            }
+        }
+
+        template <size_t ROUNDS>
+        static void decrypt(std::span<state_t> blocks, const std::array<state_t, ROUNDS> &keys) {
+            decrypt(blocks, key_schedule_t<ROUNDS>{keys, Common::decryption_keys(keys)});
+        }
+
+        static state_t encryption_round(const state_t &state) {
+            state_t result;
             for (auto i = 0U; i < state.size(); ++i) {
-                state[state.size() - 1 - i] = (((copy[0] >> (8 * i)) & 0xFF) << 24) | //
-                                              (((copy[1] >> (8 * i)) & 0xFF) << 16) | //
-                                              (((copy[2] >> (8 * i)) & 0xFF) << 8) |  //
-                                              (((copy[3] >> (8 * i)) & 0xFF) << 0);
+                result[i] = Te0[byte<0>(state[i])] ^ Te1[byte<1>(state[(i + 1) % 4])] ^
+                            Te2[byte<2>(state[(i + 2) % 4])] ^ Te3[byte<3>(state[(i + 3) % 4])];
             }
-            return state;
+            return result;
+        }
+
+        static state_t encryption_final_round(const state_t &state) {
+            const auto &sbox = Encryption::sbox;
+            state_t result;
+            for (auto i = 0U; i < state.size(); ++i) {
+                result[i] = (uint32_t(sbox[byte<0>(state[i])]) << 24) |
+                            (uint32_t(sbox[byte<1>(state[(i + 1) % 4])]) << 16) |
+                            (uint32_t(sbox[byte<2>(state[(i + 2) % 4])]) << 8) |
+                            (uint32_t(sbox[byte<3>(state[(i + 3) % 4])]) << 0);
+            }
+            return result;
         }
+
+        static state_t decryption_round(const state_t &state) {
+            state_t result;
+            for (auto i = 0U; i < state.size(); ++i) {
+                result[i] = Td0[byte<0>(state[i])] ^ Td1[byte<1>(state[(i + 3) % 4])] ^
+                            Td2[byte<2>(state[(i + 2) % 4])] ^ Td3[byte<3>(state[(i + 1) % 4])];
+            }
+            return result;
+        }
+
+        static state_t decryption_final_round(const state_t &state) {
+            const auto &sbox = Decryption::sbox;
+            state_t result;
+            for (auto i = 0U; i < state.size(); ++i) {
+                result[i] = (uint32_t(sbox[byte<0>(state[i])]) << 24) |
+                            (uint32_t(sbox[byte<1>(state[(i + 3) % 4])]) << 16) |
+                            (uint32_t(sbox[byte<2>(state[(i + 2) % 4])]) << 8) |
+                            (uint32_t(sbox[byte<3>(state[(i + 1) % 4])]) << 0);
+            }
+            return result;
+        }
+
+        template <int row> static constexpr uint8_t byte(uint32_t column) { return column >> (24 - 8 * row); }
+
+        // column of the product of the mix matrix with a single byte in row 0, rotated for the other rows
+        static constexpr auto make_table = [](const std::array<uint8_t, 256> &sbox,
+                                              std::array<uint8_t, 4> factors, int row) {
+            constexpr auto multiply = [](uint8_t value, uint8_t factor) {
+                uint8_t result = 0;
+                for (; factor != 0; factor >>= 1) {
+                    if (factor & 1) {
+                        result ^= value;
+                    }
+                    value = (value << 1) ^ ((value >> 7) * 0x1b);
+                }
+                return result;
+            };
+
+            std::array<uint32_t, 256> table{};
+            for (auto i = 0U; i < table.size(); ++i) {
+                uint32_t column = 0;
+                for (auto factor : factors) {
+                    column = (column << 8) | multiply(sbox[i], factor);
+                }
+                table[i] = row == 0 ? column : (column >> (8 * row)) | (column << (32 - 8 * row));
+            }
+            return table;
+        };
+
+        static constexpr auto Te0 = make_table(Encryption::sbox, {0x02, 0x01, 0x01, 0x03}, 0);
+        static constexpr auto Te1 = make_table(Encryption::sbox, {0x02, 0x01, 0x01, 0x03}, 1);
+        static constexpr auto Te2 = make_table(Encryption::sbox, {0x02, 0x01, 0x01, 0x03}, 2);
+        static constexpr auto Te3 = make_table(Encryption::sbox, {0x02, 0x01, 0x01, 0x03}, 3);
+        static constexpr auto Td0 = make_table(Decryption::sbox, {0x0e, 0x09, 0x0d, 0x0b}, 0);
+        static constexpr auto Td1 = make_table(Decryption::sbox, {0x0e, 0x09, 0x0d, 0x0b}, 1);
+        static constexpr auto Td2 = make_table(Decryption::sbox, {0x0e, 0x09, 0x0d, 0x0b}, 2);
+        static constexpr auto Td3 = make_table(Decryption::sbox, {0x0e, 0x09, 0x0d, 0x0b}, 3);
+    };
+
+    // constant time engine, bit p of every byte of 8 blocks is collected in plane p. Inside a plane the
+    // layout follows state_t, one column per lane with row 0 in the top byte, and bit b of a byte belongs
+    // to block b.
+    // Sub bytes becomes a boolean circuit over the planes, row shift and mix columns only move bytes around.
+    struct Bitsliced {
+        static constexpr size_t block_count = 8;
+        using plane_t [[gnu::vector_size(16)]] = uint32_t;
+        using planes_t = std::array<plane_t, 8>;
+        template <size_t ROUNDS> using sliced_keys_t = std::array<planes_t, ROUNDS>;
+
+        // every block of the group gets the same key, each byte of a key plane is either all ones or zero
+        template <size_t ROUNDS>
+        static sliced_keys_t<ROUNDS> slice_keys(const std::array<state_t, ROUNDS> &keys) {
+            sliced_keys_t<ROUNDS> sliced;
+            for (auto i = 0U; i < keys.size(); ++i) {
+                std::array<state_t, block_count> copies;
+                copies.fill(keys[i]);
+                sliced[i] = pack(copies);
+            }
+            return sliced;
+        }
+
+        template <size_t ROUNDS>
+        static void encrypt(std::span<state_t> blocks, const std::array<state_t, ROUNDS> &keys) {
+            encrypt(blocks, slice_keys(keys));
+        }
+
+        template <size_t ROUNDS>
+        static void decrypt(std::span<state_t> blocks, const std::array<state_t, ROUNDS> &keys) {
+            decrypt(blocks, slice_keys(keys));
+        }
+
+        template <size_t ROUNDS>
+        static void encrypt(std::span<state_t> blocks, const sliced_keys_t<ROUNDS> &keys) {
+            for (auto offset = 0U; offset < blocks.size(); offset += block_count) {
+                const auto group = blocks.subspan(offset, std::min(block_count, blocks.size() - offset));
+                auto planes = pack(group);
+                add_round_key(planes, keys.front());
+                for (auto i = 1U; i < keys.size() - 1; ++i) {
+                    substitute_bytes(planes);
+                    row_shift(planes);
+                    mix_columns(planes);
+                    add_round_key(planes, keys[i]);
+                }
+                substitute_bytes(planes);
+                row_shift(planes);
+                add_round_key(planes, keys.back());
+                unpack(planes, group);
+            }
+        }
+
+        template <size_t ROUNDS>
+        static void decrypt(std::span<state_t> blocks, const sliced_keys_t<ROUNDS> &keys) {
+            for (auto offset = 0U; offset < blocks.size(); offset += block_count) {
+                const auto group = blocks.subspan(offset, std::min(block_count, blocks.size() - offset));
+                auto planes = pack(group);
+                add_round_key(planes, keys.back());
+                inverse_row_shift(planes);
+                inverse_substitute_bytes(planes);
+                for (auto i = keys.size() - 2; i > 0; --i) {
+                    add_round_key(planes, keys[i]);
+                    inverse_mix_columns(planes);
+                    inverse_row_shift(planes);
+                    inverse_substitute_bytes(planes);
+                }
+                add_round_key(planes, keys.front());
+                unpack(planes, group);
+            }
+        }
+
+        static planes_t pack(std::span<const state_t> blocks) {
+            planes_t planes{};
+            for (auto i = 0U; i < blocks.size(); ++i) {
+                planes[i] = plane_t{blocks[i][0], blocks[i][1], blocks[i][2], blocks[i][3]};
+            }
+            orthogonalize(planes);
+            return planes;
+        }
+
+        static void unpack(planes_t planes, std::span<state_t> blocks) {
+            orthogonalize(planes);
+            for (auto i = 0U; i < blocks.size(); ++i) {
+                blocks[i] = state_t{planes[i][0], planes[i][1], planes[i][2], planes[i][3]};
+            }
+        }
+
+        // transposes the 8x8 bit matrices formed by one byte position of all planes,
+        // afterwards bit j of a byte in plane i holds what was bit i of the byte in plane j
+        static void orthogonalize(planes_t &planes) {
+            const auto swap = [](plane_t &low, plane_t &high, uint32_t mask, int shift) {
+                const auto t = ((low >> shift) ^ high) & mask;
+                high ^= t;
+                low ^= t << shift;
+            };
+            for (auto i = 0U; i < 8; i += 2) {
+                swap(planes[i], planes[i + 1], 0x55555555U, 1);
+            }
+            for (auto i : {0U, 1U, 4U, 5U}) {
+                swap(planes[i], planes[i + 2], 0x33333333U, 2);
+            }
+            for (auto i = 0U; i < 4; ++i) {
+                swap(planes[i], planes[i + 4], 0x0F0F0F0FU, 4);
+            }
+        }
+
+        static void add_round_key(planes_t &planes, const planes_t &key) {
+            for (auto bit = 0U; bit < 8; ++bit) {
+                planes[bit] ^= key[bit];
+            }
+        }
+
+        // row r of column c moves to column c - r
+        static plane_t row_shift(plane_t plane) {
+            return (plane & 0xFF000000U) | (__builtin_shufflevector(plane, plane, 1, 2, 3, 0) & 0x00FF0000U) |
+                   (__builtin_shufflevector(plane, plane, 2, 3, 0, 1) & 0x0000FF00U) |
+                   (__builtin_shufflevector(plane, plane, 3, 0, 1, 2) & 0x000000FFU);
+        }
+
+        static plane_t inverse_row_shift(plane_t plane) {
+            return (plane & 0xFF000000U) | (__builtin_shufflevector(plane, plane, 3, 0, 1, 2) & 0x00FF0000U) |
+                   (__builtin_shufflevector(plane, plane, 2, 3, 0, 1) & 0x0000FF00U) |
+                   (__builtin_shufflevector(plane, plane, 1, 2, 3, 0) & 0x000000FFU);
+        }
+
+        static void row_shift(planes_t &planes) {
+            for (auto &plane : planes) {
+                plane = row_shift(plane);
+            }
+        }
+
+        static void inverse_row_shift(planes_t &planes) {
+            for (auto &plane : planes) {
+                plane = inverse_row_shift(plane);
+            }
+        }
+
+        // moves row r + n of every column into row r
+        template <int n> static plane_t rotate_rows(plane_t plane) {
+            return (plane << (8 * n)) | (plane >> (32 - 8 * n));
+        }
+
+        // multiplication by x, the reduction polynomial x^8 + x^4 + x^3 + x + 1 feeds bit 7 back
+        static planes_t multiply_x(const planes_t &a) {
+            return {a[7], a[0] ^ a[7], a[1], a[2] ^ a[7], a[3] ^ a[7], a[4], a[5], a[6]};
+        }
+
+        static void mix_columns(planes_t &planes) {
+            planes_t sum;
+            for (auto bit = 0U; bit < 8; ++bit) {
+                sum[bit] = planes[bit] ^ rotate_rows<1>(planes[bit]);
+            }
+            // 2 * a0 + 3 * a1 + a2 + a3 == 2 * (a0 + a1) + a1 + a2 + a3
+            const auto doubled = multiply_x(sum);
+            for (auto bit = 0U; bit < 8; ++bit) {
+                planes[bit] = doubled[bit] ^ rotate_rows<1>(planes[bit]) ^ rotate_rows<2>(planes[bit]) ^
+                              rotate_rows<3>(planes[bit]);
+            }
+        }
+
+        static void inverse_mix_columns(planes_t &planes) {
+            const auto x2 = multiply_x(planes);
+            const auto x4 = multiply_x(x2);
+            const auto x8 = multiply_x(x4);
+            for (auto bit = 0U; bit < 8; ++bit) {
+                // 0xE * a0 + 0xB * a1 + 0xD * a2 + 0x9 * a3
+                const auto x9 = x8[bit] ^ planes[bit];
+                planes[bit] = (x8[bit] ^ x4[bit] ^ x2[bit]) ^ rotate_rows<1>(x9 ^ x2[bit]) ^
+                              rotate_rows<2>(x9 ^ x4[bit]) ^ rotate_rows<3>(x9);
+            }
+        }
+
+        // Boyar-Peralta circuit: inversion in GF(2^8) through towers of subfields followed by the affine map
+        static void substitute_bytes(planes_t &q) {
+            const auto x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4];
+            const auto x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+            // top linear transformation
+            const auto y14 = x3 ^ x5, y13 = x0 ^ x6, y9 = x0 ^ x3, y8 = x0 ^ x5;
+            const auto t0 = x1 ^ x2, y1 = t0 ^ x7, y4 = y1 ^ x3, y12 = y13 ^ y14;
+            const auto y2 = y1 ^ x0, y5 = y1 ^ x6, y3 = y5 ^ y8, t1 = x4 ^ y12;
+            const auto y15 = t1 ^ x5, y20 = t1 ^ x1, y6 = y15 ^ x7, y10 = y15 ^ t0;
+            const auto y11 = y20 ^ y9, y7 = x7 ^ y11, y17 = y10 ^ y11, y19 = y10 ^ y8;
+            const auto y16 = t0 ^ y11, y21 = y13 ^ y16, y18 = x0 ^ y16;
+
+            // non linear section
+            const auto t2 = y12 & y15, t3 = y3 & y6, t4 = t3 ^ t2, t5 = y4 & x7;
+            const auto t6 = t5 ^ t2, t7 = y13 & y16, t8 = y5 & y1, t9 = t8 ^ t7;
+            const auto t10 = y2 & y7, t11 = t10 ^ t7, t12 = y9 & y11, t13 = y14 & y17;
+            const auto t14 = t13 ^ t12, t15 = y8 & y10, t16 = t15 ^ t12, t17 = t4 ^ t14;
+            const auto t18 = t6 ^ t16, t19 = t9 ^ t14, t20 = t11 ^ t16, t21 = t17 ^ y20;
+            const auto t22 = t18 ^ y19, t23 = t19 ^ y21, t24 = t20 ^ y18;
+
+            const auto t25 = t21 ^ t22, t26 = t21 & t23, t27 = t24 ^ t26, t28 = t25 & t27;
+            const auto t29 = t28 ^ t22, t30 = t23 ^ t24, t31 = t22 ^ t26, t32 = t31 & t30;
+            const auto t33 = t32 ^ t24, t34 = t23 ^ t33, t35 = t27 ^ t33, t36 = t24 & t35;
+            const auto t37 = t36 ^ t34, t38 = t27 ^ t36, t39 = t29 & t38, t40 = t25 ^ t39;
+
+            const auto t41 = t40 ^ t37, t42 = t29 ^ t33, t43 = t29 ^ t40, t44 = t33 ^ t37;
+            const auto t45 = t42 ^ t41;
+            const auto z0 = t44 & y15, z1 = t37 & y6, z2 = t33 & x7, z3 = t43 & y16;
+            const auto z4 = t40 & y1, z5 = t29 & y7, z6 = t42 & y11, z7 = t45 & y17;
+            const auto z8 = t41 & y10, z9 = t44 & y12, z10 = t37 & y3, z11 = t33 & y4;
+            const auto z12 = t43 & y13, z13 = t40 & y5, z14 = t29 & y2, z15 = t42 & y9;
+            const auto z16 = t45 & y14, z17 = t41 & y8;
+
+            // bottom linear transformation
+            const auto t46 = z15 ^ z16, t47 = z10 ^ z11, t48 = z5 ^ z13, t49 = z9 ^ z10;
+            const auto t50 = z2 ^ z12, t51 = z2 ^ z5, t52 = z7 ^ z8, t53 = z0 ^ z3;
+            const auto t54 = z6 ^ z7, t55 = z16 ^ z17, t56 = z12 ^ t48, t57 = t50 ^ t53;
+            const auto t58 = z4 ^ t46, t59 = z3 ^ t54, t60 = t46 ^ t57, t61 = z14 ^ t57;
+            const auto t62 = t52 ^ t58, t63 = t49 ^ t58, t64 = z4 ^ t59, t65 = t61 ^ t62;
+            const auto t66 = z1 ^ t63, t67 = t64 ^ t65;
+
+            const auto s3 = t53 ^ t66;
+            q[7] = t59 ^ t63;
+            q[6] = t64 ^ ~s3;
+            q[5] = t55 ^ ~t67;
+            q[4] = s3;
+            q[3] = t51 ^ t66;
+            q[2] = t47 ^ t65;
+            q[1] = t56 ^ ~t62;
+            q[0] = t48 ^ ~t60;
+        }
+
+        // S(x) = A(I(x)) + 0x63 with the linear map A and the inversion I, as I is an involution the inverse
+        // is B(S(B(x + 0x63)) + 0x63) with B the inverse of A
+        static void inverse_substitute_bytes(planes_t &q) {
+            inverse_affine(q);
+            substitute_bytes(q);
+            inverse_affine(q);
+        }
+
+        static void inverse_affine(planes_t &q) {
+            const auto q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3];
+            const auto q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+            q[7] = q1 ^ q4 ^ q6;
+            q[6] = q0 ^ q3 ^ q5;
+            q[5] = q7 ^ q2 ^ q4;
+            q[4] = q6 ^ q1 ^ q3;
+            q[3] = q5 ^ q0 ^ q2;
+            q[2] = q4 ^ q7 ^ q1;
+            q[1] = q3 ^ q6 ^ q0;
+            q[0] = q2 ^ q5 ^ q7;
+        }
+    };
+
+    // expanded keys and, when the software engine does the bulk work, their bitsliced form. Callers that
+    // pass the same keys to encrypt_blocks and decrypt_blocks batch after batch hand these in place of
+    // the keys, so the key schedule is sliced once instead of in every call. The keys are referenced.
+    // engine is the one the blocks will go through, the default is the one the dispatch picks
+    template <typename expanded_keys_t> struct Bulk_Keys {
+        using sliced_keys_t = Bitsliced::sliced_keys_t<round_key_count<expanded_keys_t>>;
+
+        explicit Bulk_Keys(const expanded_keys_t &keys, Bulk_Engine engine = bulk_engine()) : keys(keys) {
+            if (engine == Bulk_Engine::SOFTWARE) {
+                sliced = Bitsliced::slice_keys(Common::encryption_keys(keys));
+            }
+        }
+        explicit Bulk_Keys(const expanded_keys_t &&, Bulk_Engine = bulk_engine()) = delete;
+
+        const expanded_keys_t &keys;
+        std::optional<sliced_keys_t> sliced;
     };
 
-  public:
     [[gnu::hot, gnu::always_inline]]
     static constexpr uint32_t GF_MULTIPLY_SIMDx2(uint32_t value) {
         const uint32_t mask = 0x80808080U;
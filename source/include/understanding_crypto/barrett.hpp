@@ -0,0 +1,101 @@
+#ifndef UNDERSTANDING_CRYPTO_BARRETT_H
+#define UNDERSTANDING_CRYPTO_BARRETT_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include <understanding_crypto/biginteger.hpp>
+
+namespace understanding_crypto {
+// Barrett reduction modulo n >= 2 (Handbook of Applied Cryptography 14.42) with the word base b and k the
+// number of words of n. The reciprocal mu = floor(b^2k / n) is computed once by a division, after that
+// x mod n for x < b^2k costs two half multiplications and a few subtractions: only the words of q1 * mu
+// that reach the quotient estimate (14.44) and only the low k + 1 words of q3 * n are computed.
+template <std::size_t BITS> class Barrett {
+  public:
+    using number_t = uint_t<BITS>;
+    using wide_t = uint_t<2 * BITS>;
+    using value_t = typename number_t::value_t;
+    using double_value_t = typename number_t::double_value_t;
+    static constexpr auto word_count = number_t::word_count;
+    static constexpr auto bits_in_word = number_t::bits_in_word;
+    // mu <= b^(k + 1)
+    using reciprocal_t = uint_t<bits_in_word * (word_count + 2)>;
+
+    constexpr explicit Barrett(const number_t &modulus) : n(modulus), length(word_count) {
+        while (length > 1 && n[length - 1] == 0) {
+            --length;
+        }
+        uint_t<bits_in_word * (2 * word_count + 1)> power{0};
+        power.internal_main[2 * length] = 1;
+        reciprocal = reciprocal_t::from_division_of(power, n);
+    }
+
+    constexpr const number_t &modulus() const { return n; }
+
+    constexpr number_t reduce(const wide_t &x) const {
+        const auto k = length;
+        const auto x_words = std::span<const value_t>(x.internal_main);
+
+        // q1 = floor(x / b^(k - 1)); of q1 * mu only the words from k - 1 on are summed, the estimate
+        // q3 = floor(q1 * mu / b^(k + 1)) is then at most two below the exact one
+        const auto q1 = x_words.subspan(k - 1, std::min(k + 1, x_words.size() - (k - 1)));
+        const auto mu = std::span<const value_t>(reciprocal.internal_main).first(k + 2);
+        std::array<value_t, 2 * word_count + 3> q2{};
+        for (size_t i = 0; i < q1.size(); ++i) {
+            double_value_t carry = 0;
+            for (size_t j = k - 1 - std::min(i, k - 1); j < mu.size(); ++j) {
+                carry += double_value_t(q1[i]) * mu[j] + q2[i + j];
+                q2[i + j] = value_t(carry);
+                carry >>= bits_in_word;
+            }
+            q2[i + mu.size()] = value_t(carry);
+        }
+        const auto q3 = std::span<const value_t>(q2).subspan(k + 1, k + 1);
+
+        // r = x - q3 * n modulo b^(k + 1), below 5n
+        std::array<value_t, word_count + 1> r{}, subtrahend;
+        std::copy_n(x_words.begin(), std::min({k + 1, x_words.size(), r.size()}), r.begin());
+        const auto low = std::span(r).first(k + 1);
+        number_t::multiply_words(q3, std::span(n.internal_main).first(k), std::span(subtrahend).first(k + 1));
+        number_t::subtract_words(low, std::span(subtrahend).first(k + 1));
+        while (!below_modulus(low)) {
+            number_t::subtract_words(low, std::span(n.internal_main).first(k));
+        }
+
+        number_t result{0};
+        std::copy_n(r.begin(), k, result.internal_main.begin());
+        return result;
+    }
+
+    constexpr number_t multiply(const number_t &a, const number_t &b) const {
+        return reduce(wide_t::from_multiplication_of(a, b));
+    }
+
+    constexpr number_t square(const number_t &a) const { return reduce(wide_t::from_square_of(a)); }
+
+  private:
+    // r has k + 1 words
+    constexpr bool below_modulus(std::span<const value_t> r) const {
+        if (r[length] != 0) {
+            return false;
+        }
+        for (size_t i = length; i-- > 0;) {
+            if (r[i] != n[i]) {
+                return r[i] < n[i];
+            }
+        }
+        return false;
+    }
+
+    number_t n;
+    // k, words of n without the leading zero words
+    size_t length;
+    reciprocal_t reciprocal;
+};
+} // namespace understanding_crypto
+
+#endif
@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <stdexcept>
 
 namespace understanding_crypto {
 template <std::size_t BITS> struct uint_t {
@@ -17,6 +20,10 @@ template <std::size_t BITS> struct uint_t {
     using half_value_t =
         std::conditional_t<sizeof(value_t) == sizeof(uint64_t), uint32_t,
                            std::conditional_t<sizeof(value_t) == sizeof(uint32_t), uint16_t, void>>;
+    // holds the full product of two words
+    __extension__ using double_value_t =
+        std::conditional_t<sizeof(value_t) == sizeof(uint64_t), unsigned __int128,
+                           std::conditional_t<sizeof(value_t) == sizeof(uint32_t), uint64_t, void>>;
 
     static constexpr auto bit_count = BITS;
     static constexpr auto bits_in_word = 8 * sizeof(value_t);
@@ -82,6 +89,24 @@ template <std::size_t BITS> struct uint_t {
         return *this;
     }
 
+    // an expression of biginteger_expression.hpp, evaluated in one pass from the lowest word up. Word i of
+    // the operands is read before word i of this is written, so this may appear in the expression
+    template <typename expression_t>
+        requires requires { typename expression_t::expression_tag; }
+    constexpr uint_t(expression_t expression) {
+        *this = expression;
+    }
+
+    template <typename expression_t>
+        requires requires { typename expression_t::expression_tag; }
+    constexpr this_t &operator=(expression_t expression) {
+        for (size_t i = 0; i < word_count; ++i) {
+            internal_main[i] = expression.next(i);
+        }
+        trim();
+        return *this;
+    }
+
     template <bool shift_left, size_t lhs_bits>
     constexpr static this_t from_shift_by(uint_t<lhs_bits> const &lhs, std::integral auto rhs) {
         if constexpr (std::is_signed_v<decltype(rhs)>) {
@@ -94,14 +119,17 @@ template <std::size_t BITS> struct uint_t {
         using res_t = this_t;
         res_t res{0};
 
-        if (rhs > lhs_bits || rhs > bit_count) {
+        // not negative past this point
+        const auto shift = size_t(rhs);
+        if (shift > lhs_bits || shift > bit_count) {
             return res;
         }
 
-        constexpr size_t max_length = std::min(lhs_bits, bit_count) / bits_in_word;
-        size_t word_shift = rhs / bits_in_word;
-        size_t in_word_shift = rhs % bits_in_word;
-        if ((rhs % bits_in_word) == 0) {
+        // whole words, a partial last word takes part in the shift
+        constexpr size_t max_length = std::min(lhs_t::word_count, res_t::word_count);
+        size_t word_shift = shift / bits_in_word;
+        size_t in_word_shift = shift % bits_in_word;
+        if (in_word_shift == 0) {
             if constexpr (shift_left) {
                 std::copy_n(lhs.internal_main.begin(), max_length - word_shift,
                             res.internal_main.begin() + word_shift);
@@ -128,6 +156,132 @@ template <std::size_t BITS> struct uint_t {
         return res;
     }
 
+    // operands with at least this many words are multiplied by Karatsuba when the full product is needed,
+    // below it the quadratic kernels are faster
+    static constexpr size_t karatsuba_threshold = 48;
+
+    // out = lhs * rhs, truncated to the size of out. One carry chain per row of word products
+    constexpr static void multiply_words(std::span<const value_t> lhs, std::span<const value_t> rhs,
+                                         std::span<value_t> out) {
+        std::fill(out.begin(), out.end(), 0);
+        for (size_t i = 0; i < std::min(lhs.size(), out.size()); ++i) {
+            double_value_t carry = 0;
+            for (size_t j = 0; j < std::min(rhs.size(), out.size() - i); ++j) {
+                carry += double_value_t(lhs[i]) * rhs[j] + out[i + j];
+                out[i + j] = value_t(carry);
+                carry >>= bits_in_word;
+            }
+            // no earlier row reached this word
+            if (i + rhs.size() < out.size()) {
+                out[i + rhs.size()] = value_t(carry);
+            }
+        }
+    }
+
+    // out = x * x, truncated to the size of out. Every cross product x[i] * x[j] with i < j is computed
+    // once and doubled by a shift, then the squares on the diagonal are added
+    constexpr static void square_words(std::span<const value_t> x, std::span<value_t> out) {
+        std::fill(out.begin(), out.end(), 0);
+        for (size_t i = 0; i < std::min(x.size(), out.size()); ++i) {
+            double_value_t carry = 0;
+            for (size_t j = i + 1; j < std::min(x.size(), out.size() - i); ++j) {
+                carry += double_value_t(x[i]) * x[j] + out[i + j];
+                out[i + j] = value_t(carry);
+                carry >>= bits_in_word;
+            }
+            if (i + x.size() < out.size()) {
+                out[i + x.size()] = value_t(carry);
+            }
+        }
+
+        value_t shifted_out = 0;
+        for (auto &word : out) {
+            const auto next = word >> (bits_in_word - 1);
+            word = (word << 1) | shifted_out;
+            shifted_out = next;
+        }
+        double_value_t carry = 0;
+        for (size_t i = 0; i < std::min(x.size(), (out.size() + 1) / 2); ++i) {
+            const auto square = double_value_t(x[i]) * x[i];
+            carry += double_value_t(out[2 * i]) + value_t(square);
+            out[2 * i] = value_t(carry);
+            carry >>= bits_in_word;
+            if (2 * i + 1 < out.size()) {
+                carry += double_value_t(out[2 * i + 1]) + value_t(square >> bits_in_word);
+                out[2 * i + 1] = value_t(carry);
+                carry >>= bits_in_word;
+            }
+        }
+    }
+
+    // the full 2 * N word product of N word operands, rhs is lhs when squaring. With a = a1 * B + a0,
+    // B = 2^(bits_in_word * h): a * b = z2 * B^2 + z1 * B + z0 where z1 = (a0 + a1)(b0 + b1) - z0 - z2,
+    // three half size products instead of four. Carries are added under masks, no branch on the operands
+    template <size_t N, bool squaring>
+    constexpr static void multiply_full(const value_t *lhs, const value_t *rhs, value_t *out) {
+        if constexpr (N < karatsuba_threshold) {
+            if constexpr (squaring) {
+                square_words({lhs, N}, {out, 2 * N});
+            } else {
+                multiply_words({lhs, N}, {rhs, N}, {out, 2 * N});
+            }
+        } else {
+            constexpr size_t h = (N + 1) / 2;
+            constexpr size_t high = N - h;
+            multiply_full<h, squaring>(lhs, rhs, out);
+            multiply_full<high, squaring>(lhs + h, rhs + h, out + 2 * h);
+
+            std::array<value_t, h> lhs_sum, rhs_sum;
+            std::copy_n(lhs, h, lhs_sum.begin());
+            const value_t lhs_carry = add_words(lhs_sum, {lhs + h, high});
+            value_t rhs_carry = lhs_carry;
+            if constexpr (squaring) {
+                rhs_sum = lhs_sum;
+            } else {
+                std::copy_n(rhs, h, rhs_sum.begin());
+                rhs_carry = add_words(rhs_sum, {rhs + h, high});
+            }
+
+            // (a0 + a1)(b0 + b1) < 2^(2 * bits_in_word * h + 2)
+            std::array<value_t, 2 * h + 1> middle{};
+            multiply_full<h, squaring>(lhs_sum.data(), rhs_sum.data(), middle.data());
+            for (size_t i = 0; i < h; ++i) {
+                lhs_sum[i] &= 0 - rhs_carry;
+                rhs_sum[i] &= 0 - lhs_carry;
+            }
+            const auto upper = std::span(middle).subspan(h);
+            add_words(upper, lhs_sum);
+            add_words(upper, rhs_sum);
+            middle[2 * h] += lhs_carry & rhs_carry;
+
+            subtract_words(middle, {out, 2 * h});
+            subtract_words(middle, {out + 2 * h, 2 * high});
+            add_words({out + h, 2 * N - h}, middle);
+        }
+    }
+
+    // out += in for in no longer than out, the carry runs to the end of out and is returned
+    constexpr static value_t add_words(std::span<value_t> out, std::span<const value_t> in) {
+        value_t carry = 0;
+        for (size_t i = 0; i < out.size(); ++i) {
+            const auto sum = double_value_t(out[i]) + (i < in.size() ? in[i] : 0) + carry;
+            out[i] = value_t(sum);
+            carry = value_t(sum >> bits_in_word);
+        }
+        return carry;
+    }
+
+    // out -= in for in no longer than out, returns the borrow
+    constexpr static value_t subtract_words(std::span<value_t> out, std::span<const value_t> in) {
+        value_t borrow = 0;
+        for (size_t i = 0; i < out.size(); ++i) {
+            const auto difference = double_value_t(out[i]) - (i < in.size() ? in[i] : 0) - borrow;
+            out[i] = value_t(difference);
+            borrow = value_t(difference >> bits_in_word) & 1;
+        }
+        return borrow;
+    }
+
     template <size_t lhs_bits, size_t rhs_bits>
     constexpr static this_t from_multiplication_of(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
         using lhs_t = uint_t<lhs_bits>;
@@ -135,42 +289,196 @@ template <std::size_t BITS> struct uint_t {
         using res_t = this_t;
         res_t res{};
 
-        for (size_t i = 0; i < std::min(res_t::word_count, lhs_t::word_count); ++i) {
-            for (size_t j = 0; ((j + i) < res_t::word_count) && (j < rhs_t::word_count); ++j) {
-                auto low_word = half_value_t(lhs[i]) * value_t(half_value_t(rhs[j]));
-                const auto mid_lhs_word = value_t(half_value_t(lhs[i])) * (rhs[j] >> (bits_in_word / 2));
-                const auto mid_rhs_word = (lhs[i] >> (bits_in_word / 2)) * value_t(half_value_t(rhs[j]));
-
-                const size_t mid_sum_low =
-                    value_t(half_value_t(mid_lhs_word)) + value_t(half_value_t(mid_rhs_word));
-                size_t carry = mid_sum_low >> (bits_in_word / 2);
-                low_word += mid_sum_low << (bits_in_word / 2);
-                carry += (low_word < (mid_sum_low << (bits_in_word / 2)));
-                res[i + j] += low_word;
-                carry += (res[i + j] < low_word);
-
-                if ((i + j + 1) < res_t::word_count) {
-                    const size_t mid_sum_high = value_t(mid_lhs_word >> (bits_in_word / 2)) +
-                                                value_t(mid_rhs_word >> (bits_in_word / 2));
-                    auto high_word = (lhs[i] >> (bits_in_word / 2)) * (rhs[j] >> (bits_in_word / 2));
-                    high_word += carry;
-                    carry = (high_word < carry);
-                    high_word += mid_sum_high;
-                    carry += high_word < mid_sum_high;
-                    res[i + j + 1] += high_word;
-                    carry += res[i + j + 1] < high_word;
-                }
-                for (size_t k = i + j + 2; carry && (k < res_t::word_count); ++k) {
-                    res[k] += carry;
-                    carry = (res[k] < carry);
-                }
+        if constexpr (lhs_t::word_count == rhs_t::word_count && res_t::word_count >= 2 * lhs_t::word_count) {
+            // the full product, this is where Karatsuba pays off
+            const auto *lhs_words = lhs.internal_main.data();
+            const auto *rhs_words = rhs.internal_main.data();
+            if (static_cast<const void *>(&lhs) == static_cast<const void *>(&rhs)) {
+                multiply_full<lhs_t::word_count, true>(lhs_words, lhs_words, res.internal_main.data());
+            } else {
+                multiply_full<lhs_t::word_count, false>(lhs_words, rhs_words, res.internal_main.data());
             }
+        } else if (static_cast<const void *>(&lhs) == static_cast<const void *>(&rhs)) {
+            square_words(lhs.internal_main, res.internal_main);
+        } else {
+            multiply_words(lhs.internal_main, rhs.internal_main, res.internal_main);
         }
 
         res.trim();
         return res;
     }
 
+    template <size_t bits> constexpr static this_t from_square_of(uint_t<bits> const &x) {
+        return from_multiplication_of(x, x);
+    }
+
+    // u = quotient * v + remainder by Algorithm D (Knuth, TAOCP vol. 2, 4.3.1) on whole words. The
+    // divisor is shifted until its top bit is set, then every quotient word estimated from the top words
+    // of the partial remainder is at most one too large. A zero v throws std::domain_error. quotient has
+    // the size of u, remainder the size of v, scratch u.size() + v.size() + 1 words for the shifted operands
+    constexpr static void divide_words(std::span<const value_t> u, std::span<const value_t> v,
+                                       std::span<value_t> quotient, std::span<value_t> remainder,
+                                       std::span<value_t> scratch) {
+        std::fill(quotient.begin(), quotient.end(), 0);
+        std::fill(remainder.begin(), remainder.end(), 0);
+        size_t n = v.size();
+        while (n > 0 && v[n - 1] == 0) {
+            --n;
+        }
+        if (n == 0) {
+            throw std::domain_error("division by zero");
+        }
+        size_t m = u.size();
+        while (m > 0 && u[m - 1] == 0) {
+            --m;
+        }
+        if (m < n) {
+            std::copy_n(u.begin(), m, remainder.begin());
+            return;
+        }
+        if (n == 1) {
+            remainder[0] = divide_by_word(u.first(m), v[0], quotient);
+            return;
+        }
+
+        const auto shift = size_t(std::countl_zero(v[n - 1]));
+        const auto vn = scratch.first(n);
+        const auto un = scratch.subspan(n, m + 1);
+        for (size_t i = n - 1; i > 0; --i) {
+            vn[i] = v[i] << shift | spill(v[i - 1], shift);
+        }
+        vn[0] = v[0] << shift;
+        un[m] = spill(u[m - 1], shift);
+        for (size_t i = m - 1; i > 0; --i) {
+            un[i] = u[i] << shift | spill(u[i - 1], shift);
+        }
+        un[0] = u[0] << shift;
+
+        for (size_t j = m - n + 1; j-- > 0;) {
+            const auto top = double_value_t(un[j + n]) << bits_in_word | un[j + n - 1];
+            auto estimate = top / vn[n - 1];
+            auto rest = top % vn[n - 1];
+            while (estimate >> bits_in_word != 0 ||
+                   estimate * vn[n - 2] > (rest << bits_in_word | un[j + n - 2])) {
+                --estimate;
+                rest += vn[n - 1];
+                if (rest >> bits_in_word != 0) {
+                    break;
+                }
+            }
+
+            // un[j .. j + n] -= estimate * vn
+            double_value_t carry = 0;
+            value_t borrow = 0;
+            for (size_t i = 0; i < n; ++i) {
+                carry += double_value_t(value_t(estimate)) * vn[i];
+                const auto difference = double_value_t(un[i + j]) - value_t(carry) - borrow;
+                un[i + j] = value_t(difference);
+                borrow = value_t(difference >> bits_in_word) & 1;
+                carry >>= bits_in_word;
+            }
+            const auto difference = double_value_t(un[j + n]) - value_t(carry) - borrow;
+            un[j + n] = value_t(difference);
+
+            // the estimate was one too large, add vn back
+            if (difference >> bits_in_word != 0) {
+                --estimate;
+                un[j + n] += add_words(un.subspan(j, n), vn);
+            }
+            quotient[j] = value_t(estimate);
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            remainder[i] = un[i] >> shift | (un[i + 1] << 1) << (bits_in_word - 1 - shift);
+        }
+    }
+
+    template <size_t lhs_words, size_t rhs_words>
+    constexpr static void divide_words(const std::array<value_t, lhs_words> &u,
+                                       const std::array<value_t, rhs_words> &v,
+                                       std::array<value_t, lhs_words> &quotient,
+                                       std::array<value_t, rhs_words> &remainder) {
+        if constexpr (rhs_words == 1) {
+            if (v[0] == 0) {
+                throw std::domain_error("division by zero");
+            }
+            remainder[0] = divide_by_word(u, v[0], quotient);
+        } else {
+            std::array<value_t, lhs_words + rhs_words + 1> scratch;
+            divide_words(std::span<const value_t>(u), std::span<const value_t>(v), quotient, remainder,
+                         scratch);
+        }
+    }
+
+    // quotient = u / divisor for a divisor that is not zero, returns the remainder
+    constexpr static value_t divide_by_word(std::span<const value_t> u, value_t divisor,
+                                            std::span<value_t> quotient) {
+        double_value_t rest = 0;
+        for (size_t j = u.size(); j-- > 0;) {
+            rest = rest << bits_in_word | u[j];
+            quotient[j] = value_t(rest / divisor);
+            rest %= divisor;
+        }
+        return value_t(rest);
+    }
+
+    // -1, 0 or 1 as lhs is below, equal to or above rhs, the shorter one extended by zero words
+    constexpr static int compare_words(std::span<const value_t> lhs, std::span<const value_t> rhs) {
+        for (size_t i = std::max(lhs.size(), rhs.size()); i-- > 0;) {
+            const auto a = i < lhs.size() ? lhs[i] : 0;
+            const auto b = i < rhs.size() ? rhs[i] : 0;
+            if (a != b) {
+                return a < b ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // in place, bits shifted out of the span are lost. The left shift runs from the top word down and
+    // the right shift from the bottom up, so every word is read before it is overwritten
+    constexpr static void shift_left_words(std::span<value_t> words, size_t shift) {
+        const size_t word_shift = shift / bits_in_word;
+        const size_t bit_shift = shift % bits_in_word;
+        for (size_t i = words.size(); i-- > 0;) {
+            const auto high = i >= word_shift ? words[i - word_shift] << bit_shift : 0;
+            const auto low = i > word_shift ? spill(words[i - word_shift - 1], bit_shift) : 0;
+            words[i] = high | low;
+        }
+    }
+
+    constexpr static void shift_right_words(std::span<value_t> words, size_t shift) {
+        const size_t word_shift = shift / bits_in_word;
+        const size_t bit_shift = shift % bits_in_word;
+        for (size_t i = 0; i < words.size(); ++i) {
+            const auto source = i + word_shift;
+            const auto low = source < words.size() ? words[source] >> bit_shift : 0;
+            // the bits a right shift moves in from the word above, also for a shift of zero
+            const auto high = source + 1 < words.size()
+                                  ? (words[source + 1] << 1) << (bits_in_word - 1 - bit_shift)
+                                  : 0;
+            words[i] = low | high;
+        }
+    }
+
+    // the bits a left shift by shift moves out of x, also for a shift of zero
+    static constexpr value_t spill(value_t x, size_t shift) { return (x >> 1) >> (bits_in_word - 1 - shift); }
+
+    template <size_t lhs_bits, size_t rhs_bits>
+    constexpr static this_t from_division_of(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
+        uint_t<lhs_bits> quotient;
+        uint_t<rhs_bits> remainder;
+        divide_words(lhs.internal_main, rhs.internal_main, quotient.internal_main, remainder.internal_main);
+        return this_t{quotient};
+    }
+
+    template <size_t lhs_bits, size_t rhs_bits>
+    constexpr static this_t from_remainder_of(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
+        uint_t<lhs_bits> quotient;
+        uint_t<rhs_bits> remainder;
+        divide_words(lhs.internal_main, rhs.internal_main, quotient.internal_main, remainder.internal_main);
+        return this_t{remainder};
+    }
+
     template <Compare_Operation operation, size_t lhs_bits, size_t rhs_bits>
     constexpr static auto compare(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
         using lhs_t = uint_t<lhs_bits>;
@@ -192,7 +500,7 @@ template <std::size_t BITS> struct uint_t {
             }
         };
 
-        for (size_t i = max_index - 1; i > (min_index - 1); ++i) {
+        for (size_t i = max_index - 1; i > (min_index - 1); --i) {
             if constexpr (max_index == lhs_t::word_count) {
                 if (lhs[i] == 0)
                     continue;
@@ -297,6 +605,139 @@ template <std::size_t BITS> struct uint_t {
         return res;
     }
 
+    // this += rhs + carry in place, rhs taken modulo 2^BITS. Returns the carry out of bit BITS
+    template <size_t bits> constexpr value_t add_with_carry(uint_t<bits> const &rhs, value_t carry = 0) {
+        for (size_t i = 0; i < word_count; ++i) {
+            const auto word = internal_main[i];
+            const auto sum = word + word_of(rhs, i);
+            internal_main[i] = sum + carry;
+            carry = (sum < word) | (internal_main[i] < sum);
+        }
+        if constexpr (bit_count_last_word > 0) {
+            carry = internal_main.back() >> bit_count_last_word;
+            trim();
+        }
+        return carry;
+    }
+
+    // this -= rhs + borrow in place, rhs taken modulo 2^BITS. Returns the borrow out of bit BITS
+    template <size_t bits>
+    constexpr value_t subtract_with_borrow(uint_t<bits> const &rhs, value_t borrow = 0) {
+        for (size_t i = 0; i < word_count; ++i) {
+            const auto word = internal_main[i];
+            const auto difference = word - word_of(rhs, i);
+            internal_main[i] = difference - borrow;
+            borrow = (difference > word) | (internal_main[i] > difference);
+        }
+        if constexpr (bit_count_last_word > 0) {
+            borrow = (internal_main.back() >> bit_count_last_word) & 1;
+            trim();
+        }
+        return borrow;
+    }
+
+    // the compound operators work in place and keep the width of the left side, the result is taken
+    // modulo 2^BITS like for the built-in unsigned types
+    template <size_t bits> constexpr this_t &operator+=(uint_t<bits> const &rhs) {
+        add_with_carry(rhs);
+        return *this;
+    }
+
+    template <size_t bits> constexpr this_t &operator-=(uint_t<bits> const &rhs) {
+        subtract_with_borrow(rhs);
+        return *this;
+    }
+
+    // rows from the top word down: row i only writes words from i on, the words below i still hold the
+    // multiplicand. a *= a needs the whole multiplicand in every row and goes through the squaring
+    template <size_t bits> constexpr this_t &operator*=(uint_t<bits> const &rhs) {
+        if (static_cast<const void *>(this) == static_cast<const void *>(&rhs)) {
+            return *this = from_square_of(*this);
+        }
+        constexpr auto rhs_count = uint_t<bits>::word_count;
+        for (size_t i = word_count; i-- > 0;) {
+            const auto word = internal_main[i];
+            internal_main[i] = 0;
+            double_value_t carry = 0;
+            size_t j = 0;
+            for (; j < std::min(rhs_count, word_count - i); ++j) {
+                carry += double_value_t(word) * rhs[j] + internal_main[i + j];
+                internal_main[i + j] = value_t(carry);
+                carry >>= bits_in_word;
+            }
+            for (; carry != 0 && i + j < word_count; ++j) {
+                carry += internal_main[i + j];
+                internal_main[i + j] = value_t(carry);
+                carry >>= bits_in_word;
+            }
+        }
+        trim();
+        return *this;
+    }
+
+    template <size_t bits> constexpr this_t &operator&=(uint_t<bits> const &rhs) {
+        for (size_t i = 0; i < word_count; ++i) {
+            internal_main[i] &= word_of(rhs, i);
+        }
+        return *this;
+    }
+
+    template <size_t bits> constexpr this_t &operator|=(uint_t<bits> const &rhs) {
+        for (size_t i = 0; i < word_count; ++i) {
+            internal_main[i] |= word_of(rhs, i);
+        }
+        return *this;
+    }
+
+    template <size_t bits> constexpr this_t &operator^=(uint_t<bits> const &rhs) {
+        for (size_t i = 0; i < word_count; ++i) {
+            internal_main[i] ^= word_of(rhs, i);
+        }
+        return *this;
+    }
+
+    constexpr this_t &operator+=(std::integral auto rhs) { return *this += uint_t<sizeof(rhs) * 8>(rhs); }
+    constexpr this_t &operator-=(std::integral auto rhs) { return *this -= uint_t<sizeof(rhs) * 8>(rhs); }
+    constexpr this_t &operator*=(std::integral auto rhs) { return *this *= uint_t<sizeof(rhs) * 8>(rhs); }
+    constexpr this_t &operator&=(std::integral auto rhs) { return *this &= uint_t<sizeof(rhs) * 8>(rhs); }
+    constexpr this_t &operator|=(std::integral auto rhs) { return *this |= uint_t<sizeof(rhs) * 8>(rhs); }
+    constexpr this_t &operator^=(std::integral auto rhs) { return *this ^= uint_t<sizeof(rhs) * 8>(rhs); }
+
+    constexpr this_t &operator<<=(std::integral auto shift) {
+        if constexpr (std::is_signed_v<decltype(shift)>) {
+            if (shift < 0) {
+                return *this >>= size_t(-shift);
+            }
+        }
+        shift_left_words(internal_main, size_t(shift));
+        trim();
+        return *this;
+    }
+
+    constexpr this_t &operator>>=(std::integral auto shift) {
+        if constexpr (std::is_signed_v<decltype(shift)>) {
+            if (shift < 0) {
+                return *this <<= size_t(-shift);
+            }
+        }
+        shift_right_words(internal_main, size_t(shift));
+        return *this;
+    }
+
+  private:
+    // word i of rhs cut to the width of this, zero past its end
+    template <size_t bits> static constexpr value_t word_of(uint_t<bits> const &rhs, size_t i) {
+        if (i >= uint_t<bits>::word_count) {
+            return 0;
+        }
+        if constexpr (bit_count_last_word > 0) {
+            if (i == word_count - 1) {
+                return rhs[i] & ((value_t(1) << bit_count_last_word) - 1);
+            }
+        }
+        return rhs[i];
+    }
+
   public:
     constexpr auto &&operator[](this auto &&self, size_t word_index) {
         return self.internal_main[word_index];
@@ -336,6 +777,29 @@ auto operator*(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
     return res_t::from_multiplication_of(lhs, rhs);
 }
 
+template <std::size_t lhs_bits> auto operator/(uint_t<lhs_bits> const &lhs, std::integral auto rhs) {
+    using rhs_t = uint_t<sizeof(decltype(rhs)) * 8>;
+    return lhs / rhs_t(rhs);
+}
+
+template <std::size_t lhs_bits, std::size_t rhs_bits>
+auto operator/(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
+    using res_t = uint_t<lhs_bits>;
+    return res_t::from_division_of(lhs, rhs);
+}
+
+template <std::size_t lhs_bits> auto operator%(uint_t<lhs_bits> const &lhs, std::integral auto rhs) {
+    using rhs_t = uint_t<sizeof(decltype(rhs)) * 8>;
+    return lhs % rhs_t(rhs);
+}
+
+// the remainder is smaller than the divisor, so it has the type of the divisor
+template <std::size_t lhs_bits, std::size_t rhs_bits>
+auto operator%(uint_t<lhs_bits> const &lhs, uint_t<rhs_bits> const &rhs) {
+    using res_t = uint_t<rhs_bits>;
+    return res_t::from_remainder_of(lhs, rhs);
+}
+
 template <std::size_t lhs_bits> auto operator&(uint_t<lhs_bits> const &lhs, std::integral auto rhs) {
     using rhs_t = uint_t<sizeof(decltype(rhs)) * 8>;
     return lhs & rhs_t(rhs);
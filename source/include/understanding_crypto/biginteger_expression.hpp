@@ -0,0 +1,132 @@
+#ifndef UNDERSTANDING_CRYPTO_BIG_INT_EXPRESSION_H
+#define UNDERSTANDING_CRYPTO_BIG_INT_EXPRESSION_H
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <understanding_crypto/biginteger.hpp>
+
+namespace understanding_crypto {
+// expression templates for the word by word operations of uint_t. lazy(a) + b - (c ^ d) builds a tree of
+// small nodes instead of three temporaries; assigning it to a uint_t computes every word of the result in
+// a single pass, the additions and subtractions carry their carry from one word to the next. Intermediate
+// results are not cut to the width of their operands, every node is computed at the width of the
+// destination. Operands that are lvalues are referenced, temporaries are moved into the tree.
+namespace expression {
+using value_t = uint_t<1>::value_t;
+
+enum class Operation { AND, OR, XOR, ADDITION, SUBTRACTION };
+
+template <typename T>
+concept node_t = requires { typename std::remove_cvref_t<T>::expression_tag; };
+
+template <typename T> struct is_uint : std::false_type {};
+template <size_t BITS> struct is_uint<uint_t<BITS>> : std::true_type {};
+
+template <typename T>
+concept operand_t = node_t<T> || is_uint<std::remove_cvref_t<T>>::value;
+
+// a uint_t, or a reference to one
+template <typename T> struct Terminal {
+    using expression_tag = void;
+    using number_t = std::remove_cvref_t<T>;
+
+    T value;
+
+    constexpr value_t next(size_t i) const { return i < number_t::word_count ? value[i] : 0; }
+};
+
+template <Operation operation, typename lhs_t, typename rhs_t> struct Node {
+    using expression_tag = void;
+
+    lhs_t lhs;
+    rhs_t rhs;
+    value_t carry = 0;
+
+    // called once per word with increasing i
+    constexpr value_t next(size_t i) {
+        const auto a = lhs.next(i);
+        const auto b = rhs.next(i);
+        if constexpr (operation == Operation::AND) {
+            return a & b;
+        } else if constexpr (operation == Operation::OR) {
+            return a | b;
+        } else if constexpr (operation == Operation::XOR) {
+            return a ^ b;
+        } else if constexpr (operation == Operation::ADDITION) {
+            const auto sum = a + b;
+            const auto result = sum + carry;
+            carry = (sum < a) | (result < sum);
+            return result;
+        } else {
+            const auto difference = a - b;
+            const auto result = difference - carry;
+            carry = (difference > a) | (result > difference);
+            return result;
+        }
+    }
+};
+
+template <typename T> constexpr auto wrap(T &&operand) {
+    if constexpr (node_t<T>) {
+        return std::remove_cvref_t<T>(std::forward<T>(operand));
+    } else if constexpr (std::is_lvalue_reference_v<T>) {
+        return Terminal<const std::remove_cvref_t<T> &>{operand};
+    } else {
+        return Terminal<std::remove_cvref_t<T>>{std::move(operand)};
+    }
+}
+
+template <Operation operation, typename lhs_t, typename rhs_t> constexpr auto make(lhs_t &&lhs, rhs_t &&rhs) {
+    using left_t = decltype(wrap(std::forward<lhs_t>(lhs)));
+    using right_t = decltype(wrap(std::forward<rhs_t>(rhs)));
+    return Node<operation, left_t, right_t>{wrap(std::forward<lhs_t>(lhs)), wrap(std::forward<rhs_t>(rhs))};
+}
+
+// at least one side has to be an expression already, plain uint_t keep their eager operators
+template <typename lhs_t, typename rhs_t>
+concept lazy_pair = operand_t<lhs_t> && operand_t<rhs_t> && (node_t<lhs_t> || node_t<rhs_t>);
+
+template <typename lhs_t, typename rhs_t>
+    requires lazy_pair<lhs_t, rhs_t>
+constexpr auto operator+(lhs_t &&lhs, rhs_t &&rhs) {
+    return make<Operation::ADDITION>(std::forward<lhs_t>(lhs), std::forward<rhs_t>(rhs));
+}
+
+template <typename lhs_t, typename rhs_t>
+    requires lazy_pair<lhs_t, rhs_t>
+constexpr auto operator-(lhs_t &&lhs, rhs_t &&rhs) {
+    return make<Operation::SUBTRACTION>(std::forward<lhs_t>(lhs), std::forward<rhs_t>(rhs));
+}
+
+template <typename lhs_t, typename rhs_t>
+    requires lazy_pair<lhs_t, rhs_t>
+constexpr auto operator&(lhs_t &&lhs, rhs_t &&rhs) {
+    return make<Operation::AND>(std::forward<lhs_t>(lhs), std::forward<rhs_t>(rhs));
+}
+
+template <typename lhs_t, typename rhs_t>
+    requires lazy_pair<lhs_t, rhs_t>
+constexpr auto operator|(lhs_t &&lhs, rhs_t &&rhs) {
+    return make<Operation::OR>(std::forward<lhs_t>(lhs), std::forward<rhs_t>(rhs));
+}
+
+template <typename lhs_t, typename rhs_t>
+    requires lazy_pair<lhs_t, rhs_t>
+constexpr auto operator^(lhs_t &&lhs, rhs_t &&rhs) {
+    return make<Operation::XOR>(std::forward<lhs_t>(lhs), std::forward<rhs_t>(rhs));
+}
+} // namespace expression
+
+// the start of an expression
+template <typename T>
+    requires expression::is_uint<std::remove_cvref_t<T>>::value
+constexpr auto lazy(T &&value) {
+    return expression::wrap(std::forward<T>(value));
+}
+} // namespace understanding_crypto
+
+#endif
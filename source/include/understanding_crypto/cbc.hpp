@@ -0,0 +1,147 @@
+#ifndef UNDERSTANDING_CRYPTO_CBC_H
+#define UNDERSTANDING_CRYPTO_CBC_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+#include <understanding_crypto/aes.hpp>
+
+namespace understanding_crypto::aes {
+// cipher block chaining (NIST SP 800-38A), without padding: inputs are whole blocks, anything else throws
+// std::invalid_argument. The chaining value carries over between calls. The expanded keys are
+// referenced, so the constructor taking a temporary is deleted.
+template <typename expanded_keys_t> class CBC {
+  public:
+    static constexpr size_t block_size = sizeof(state_t);
+    // ciphertext decrypted per call of AES::decrypt_blocks, the engines interleave 8 or more blocks of it
+    static constexpr size_t batch_blocks = 64;
+    // streams encrypted side by side by encrypt_streams, enough to fill the widest engine
+    static constexpr size_t max_streams = 16;
+
+    // one message of encrypt_streams. chain holds the IV and receives the last ciphertext block, so the
+    // stream can be continued by another call
+    struct stream_t {
+        std::span<uint8_t, block_size> chain;
+        std::span<const uint8_t> input;
+        std::span<uint8_t> output;
+    };
+
+    CBC(const expanded_keys_t &keys, std::span<const uint8_t, block_size> iv) : keys(keys), bulk_keys(keys) {
+        std::copy(iv.begin(), iv.end(), chain.begin());
+    }
+    CBC(const expanded_keys_t &&, std::span<const uint8_t, block_size>) = delete;
+
+    // serial, every block depends on the one before. Output may be the same memory as input
+    void encrypt(std::span<const uint8_t> input, std::span<uint8_t> output) {
+        check_whole_blocks(input);
+        for (size_t offset = 0; offset + block_size <= input.size(); offset += block_size) {
+            for (auto i = 0U; i < block_size; ++i) {
+                chain[i] ^= input[offset + i];
+            }
+            AES::encrypt(block128_t{chain}, keys);
+            std::copy(chain.begin(), chain.end(), &output[offset]);
+        }
+    }
+
+    // P_i = D(C_i) ^ C_i-1 has no dependency between blocks, so a whole batch goes through the block
+    // cipher at once. The ciphertext is saved first, output may be the same memory as input
+    void decrypt(std::span<const uint8_t> input, std::span<uint8_t> output) {
+        check_whole_blocks(input);
+        std::array<uint8_t, batch_blocks * block_size> saved;
+        for (size_t offset = 0; offset + block_size <= input.size(); offset += saved.size()) {
+            const auto size = std::min(saved.size(), input.size() / block_size * block_size - offset);
+            const auto batch = output.subspan(offset, size);
+            std::copy_n(&input[offset], size, saved.begin());
+            std::copy_n(saved.begin(), size, batch.begin());
+            AES::decrypt_blocks(batch, bulk_keys);
+
+            for (auto i = 0U; i < block_size; ++i) {
+                batch[i] ^= chain[i];
+            }
+            for (auto i = block_size; i < size; ++i) {
+                batch[i] ^= saved[i - block_size];
+            }
+            std::copy_n(&saved[size - block_size], block_size, chain.begin());
+        }
+    }
+
+    // independent messages, block i of every stream is encrypted in the same call of
+    // AES::encrypt_blocks. Streams may have different lengths, the ones that run out leave the group
+    static void encrypt_streams(const expanded_keys_t &keys, std::span<const stream_t> streams) {
+        // before any stream is touched
+        for (const auto &stream : streams) {
+            check_whole_blocks(stream.input);
+        }
+        const AES::Bulk_Keys bulk_keys{keys};
+        for (size_t first = 0; first < streams.size(); first += max_streams) {
+            const auto group = streams.subspan(first, std::min(max_streams, streams.size() - first));
+            // the chaining value of active[k] lives in block k, it is the ciphertext of the step before
+            std::array<uint8_t, max_streams * block_size> blocks;
+            std::array<size_t, max_streams> active;
+            size_t count = 0;
+            for (auto i = 0U; i < group.size(); ++i) {
+                std::copy(group[i].chain.begin(), group[i].chain.end(), &blocks[count * block_size]);
+                active[count++] = i;
+            }
+
+            for (size_t offset = 0;;) {
+                size_t kept = 0;
+                auto end = SIZE_MAX;
+                for (auto k = 0U; k < count; ++k) {
+                    const auto &stream = group[active[k]];
+                    const auto size = stream.input.size() / block_size * block_size;
+                    if (size <= offset) {
+                        std::copy_n(&blocks[k * block_size], block_size, stream.chain.begin());
+                        continue;
+                    }
+                    std::copy_n(&blocks[k * block_size], block_size, &blocks[kept * block_size]);
+                    active[kept++] = active[k];
+                    end = std::min(end, size);
+                }
+                count = kept;
+                if (count == 0) {
+                    break;
+                }
+
+                const auto batch = std::span(blocks).first(count * block_size);
+                for (; offset < end; offset += block_size) {
+                    for (auto k = 0U; k < count; ++k) {
+                        xor_block(&batch[k * block_size], &group[active[k]].input[offset]);
+                    }
+                    AES::encrypt_blocks(batch, bulk_keys);
+                    for (auto k = 0U; k < count; ++k) {
+                        std::memcpy(&group[active[k]].output[offset], &batch[k * block_size], block_size);
+                    }
+                }
+            }
+        }
+    }
+
+  private:
+    static void check_whole_blocks(std::span<const uint8_t> input) {
+        if (input.size() % block_size != 0) {
+            throw std::invalid_argument("CBC input is not a multiple of the block size");
+        }
+    }
+
+    static void xor_block(uint8_t *block, const uint8_t *input) {
+        uint64_t words[2], other[2];
+        std::memcpy(words, block, block_size);
+        std::memcpy(other, input, block_size);
+        words[0] ^= other[0];
+        words[1] ^= other[1];
+        std::memcpy(block, words, block_size);
+    }
+
+    const expanded_keys_t &keys;
+    AES::Bulk_Keys<expanded_keys_t> bulk_keys;
+    std::array<uint8_t, block_size> chain;
+};
+} // namespace understanding_crypto::aes
+
+#endif
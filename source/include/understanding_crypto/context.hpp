@@ -0,0 +1,170 @@
+#ifndef UNDERSTANDING_CRYPTO_CONTEXT_H
+#define UNDERSTANDING_CRYPTO_CONTEXT_H
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+#include <understanding_crypto/aes.hpp>
+
+namespace understanding_crypto::aes {
+// the empty asm claims to read the memory, so the stores cannot be removed as dead
+inline void secure_zero(void *data, size_t size) {
+    std::memset(data, 0, size);
+    asm volatile("" : : "r"(data) : "memory");
+}
+
+// owns the encryption and decryption round keys of one key, cache line aligned, zeroed on destruction.
+// keys() can be passed wherever expanded keys are accepted
+template <typename key_t> class Context {
+  public:
+    using schedule_t = decltype(AES::Common::expand_key_schedule(std::declval<key_t>()));
+
+    explicit Context(key_t key) : schedule(AES::Common::expand_key_schedule(key)) {}
+    Context(const Context &) = delete;
+    Context &operator=(const Context &) = delete;
+    ~Context() { secure_zero(&schedule, sizeof(schedule)); }
+
+    const schedule_t &keys() const { return schedule; }
+
+    // the first round keys are the key itself, compared without an early exit
+    bool matches(key_t key) const {
+        uint8_t difference = 0;
+        for (auto i = 0U; i < key.size(); ++i) {
+            const auto word = schedule.encryption[i / 16][i / 4 % 4];
+            difference |= key[i] ^ uint8_t(word >> (24 - 8 * (i % 4)));
+        }
+        return difference == 0;
+    }
+
+    void encrypt(block128_t block) const { AES::encrypt(block, schedule); }
+    void decrypt(block128_t block) const { AES::decrypt(block, schedule); }
+    void encrypt_blocks(std::span<uint8_t> bytes) const { AES::encrypt_blocks(bytes, schedule); }
+    void decrypt_blocks(std::span<uint8_t> bytes) const { AES::decrypt_blocks(bytes, schedule); }
+
+  private:
+    alignas(64) schedule_t schedule;
+};
+
+// bounded map from keys to their contexts, so a key seen before is not expanded again. The keys are split
+// over shards by a fingerprint, a hash with a random seed per cache, and every shard evicts its least
+// recently used context. Evicted contexts are zeroed once the last caller holding one releases it.
+template <typename key_t> class Key_Cache {
+  public:
+    using context_t = Context<key_t>;
+
+    explicit Key_Cache(size_t capacity, size_t shard_count = 16)
+        : shard_count(std::max<size_t>(shard_count, 1)),
+          shard_capacity(std::max<size_t>((capacity + this->shard_count - 1) / this->shard_count, 1)),
+          shards(std::make_unique<Shard[]>(this->shard_count)), seed(std::random_device{}()) {
+        seed = seed << 32 | std::random_device{}();
+    }
+
+    std::shared_ptr<const context_t> get(key_t key) {
+        const auto hash = fingerprint(key);
+        auto &shard = shards[hash % shard_count];
+        {
+            std::lock_guard lock(shard.mutex);
+            if (auto context = shard.find(hash, key)) {
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                return context;
+            }
+        }
+
+        // expanded outside the lock, another thread may have inserted the same key meanwhile
+        auto context = std::make_shared<const context_t>(key);
+        std::lock_guard lock(shard.mutex);
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        if (auto existing = shard.find(hash, key)) {
+            return existing;
+        }
+        shard.insert(hash, context, shard_capacity);
+        return context;
+    }
+
+    uint64_t hits() const { return sum(&Shard::hits); }
+    uint64_t misses() const { return sum(&Shard::misses); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (auto i = 0U; i < shard_count; ++i) {
+            std::lock_guard lock(shards[i].mutex);
+            total += shards[i].entries.size();
+        }
+        return total;
+    }
+
+  private:
+    struct Entry {
+        uint64_t fingerprint;
+        std::shared_ptr<const context_t> context;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        // most recently used first
+        std::list<Entry> entries;
+        std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index;
+        std::atomic<uint64_t> hits = 0;
+        std::atomic<uint64_t> misses = 0;
+
+        std::shared_ptr<const context_t> find(uint64_t fingerprint, key_t key) {
+            const auto found = index.find(fingerprint);
+            if (found == index.end() || !found->second->context->matches(key)) {
+                return nullptr;
+            }
+            entries.splice(entries.begin(), entries, found->second);
+            return found->second->context;
+        }
+
+        // a different key with the same fingerprint is replaced
+        void insert(uint64_t fingerprint, std::shared_ptr<const context_t> context, size_t capacity) {
+            if (const auto found = index.find(fingerprint); found != index.end()) {
+                entries.erase(found->second);
+                index.erase(found);
+            }
+            entries.push_front({fingerprint, std::move(context)});
+            index.emplace(fingerprint, entries.begin());
+            while (entries.size() > capacity) {
+                index.erase(entries.back().fingerprint);
+                entries.pop_back();
+            }
+        }
+    };
+
+    uint64_t fingerprint(key_t key) const {
+        auto hash = seed;
+        for (auto offset = 0U; offset < key.size(); offset += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, &key[offset], sizeof(word));
+            hash = (hash ^ word) * 0x9e3779b97f4a7c15;
+            hash ^= hash >> 29;
+        }
+        return hash;
+    }
+
+    uint64_t sum(std::atomic<uint64_t> Shard::*counter) const {
+        uint64_t total = 0;
+        for (auto i = 0U; i < shard_count; ++i) {
+            total += (shards[i].*counter).load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    size_t shard_count;
+    size_t shard_capacity;
+    std::unique_ptr<Shard[]> shards;
+    uint64_t seed;
+};
+} // namespace understanding_crypto::aes
+
+#endif
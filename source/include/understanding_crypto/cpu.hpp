@@ -0,0 +1,46 @@
+#ifndef UNDERSTANDING_CRYPTO_CPU_H
+#define UNDERSTANDING_CRYPTO_CPU_H
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UNDERSTANDING_CRYPTO_X86 1
+#endif
+
+namespace understanding_crypto::cpu {
+struct Features {
+    bool aes = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool pclmul = false;
+    bool avx2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512ifma = false;
+    bool vaes = false;
+    bool sha = false;
+};
+
+// evaluated on first use and cached, every later call is a plain load
+inline const Features &features() {
+    static const Features detected = [] {
+        Features result;
+#ifdef UNDERSTANDING_CRYPTO_X86
+        __builtin_cpu_init();
+        result.aes = __builtin_cpu_supports("aes");
+        result.ssse3 = __builtin_cpu_supports("ssse3");
+        result.sse41 = __builtin_cpu_supports("sse4.1");
+        result.pclmul = __builtin_cpu_supports("pclmul");
+        result.avx2 = __builtin_cpu_supports("avx2");
+        result.avx512f = __builtin_cpu_supports("avx512f");
+        result.avx512bw = __builtin_cpu_supports("avx512bw");
+        result.avx512ifma = __builtin_cpu_supports("avx512ifma");
+        result.vaes = __builtin_cpu_supports("vaes");
+        result.sha = __builtin_cpu_supports("sha");
+#endif
+        return result;
+    }();
+    return detected;
+}
+} // namespace understanding_crypto::cpu
+
+#endif
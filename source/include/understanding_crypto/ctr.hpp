@@ -0,0 +1,87 @@
+#ifndef UNDERSTANDING_CRYPTO_CTR_H
+#define UNDERSTANDING_CRYPTO_CTR_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include <understanding_crypto/aes.hpp>
+
+namespace understanding_crypto::aes {
+// counter mode (NIST SP 800-38A), the whole 16 byte block is a big endian counter.
+// Encryption and decryption are the same operation. The expanded keys are referenced and have to outlive the
+// mode, a temporary does not compile.
+template <typename expanded_keys_t> class CTR {
+  public:
+    // keystream generated per call of AES::encrypt_blocks
+    static constexpr size_t batch_blocks = 64;
+    static constexpr size_t block_size = sizeof(state_t);
+
+    CTR(const expanded_keys_t &keys, std::span<const uint8_t, block_size> counter_block)
+        : bulk_keys(keys) {
+        for (auto i = 0U; i < 8; ++i) {
+            counter_high = (counter_high << 8) | counter_block[i];
+            counter_low = (counter_low << 8) | counter_block[i + 8];
+        }
+    }
+    CTR(const expanded_keys_t &&, std::span<const uint8_t, block_size>) = delete;
+
+    // byte offset into the keystream, relative to the initial counter block
+    void seek(uint64_t offset) { position = offset; }
+    uint64_t tell() const { return position; }
+
+    // output may be the same memory as input, it has to be at least as long as input
+    void process(std::span<const uint8_t> input, std::span<uint8_t> output) {
+        std::array<uint8_t, batch_blocks * block_size> keystream;
+
+        while (!input.empty()) {
+            const auto skip = position % block_size;
+            const auto block_count =
+                std::min(batch_blocks, (skip + input.size() + block_size - 1) / block_size);
+            const auto length = std::min(input.size(), block_count * block_size - skip);
+
+            const auto batch = std::span(keystream).first(block_count * block_size);
+            counter_blocks(position / block_size, batch);
+            AES::encrypt_blocks(batch, bulk_keys);
+
+            for (auto i = 0U; i < length; ++i) {
+                output[i] = input[i] ^ keystream[skip + i];
+            }
+            input = input.subspan(length);
+            output = output.subspan(length);
+            position += length;
+        }
+    }
+
+    // initial counter plus index, then one per block, wrapping around at 2^128.
+    // The blocks are written in byte order, ready for AES::encrypt_blocks
+    void counter_blocks(uint64_t index, std::span<uint8_t> blocks) const {
+        auto low = counter_low + index;
+        auto high = counter_high + (low < index);
+        for (auto offset = 0U; offset + block_size <= blocks.size(); offset += block_size) {
+            store_big_endian(high, &blocks[offset]);
+            store_big_endian(low, &blocks[offset + sizeof(low)]);
+            high += (++low == 0);
+        }
+    }
+
+    static void store_big_endian(uint64_t value, uint8_t *bytes) {
+        if constexpr (std::endian::native == std::endian::little) {
+            value = std::byteswap(value);
+        }
+        std::memcpy(bytes, &value, sizeof(value));
+    }
+
+  private:
+    AES::Bulk_Keys<expanded_keys_t> bulk_keys;
+    uint64_t counter_high = 0;
+    uint64_t counter_low = 0;
+    uint64_t position = 0;
+};
+} // namespace understanding_crypto::aes
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef UNDERSTANDING_CRYPTO_DRBG_H
+#define UNDERSTANDING_CRYPTO_DRBG_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <system_error>
+
+#include <understanding_crypto/aes.hpp>
+#include <understanding_crypto/context.hpp>
+#include <understanding_crypto/ctr.hpp>
+
+#include <pthread.h>
+#include <sys/random.h>
+
+namespace understanding_crypto::aes {
+// CTR_DRBG (NIST SP 800-90A 10.2.1) with AES-256 and without derivation function, so the entropy input is
+// full entropy and exactly seed_size bytes. Key and V are zeroed on destruction.
+class CTR_DRBG {
+  public:
+    static constexpr size_t key_size = 32;
+    static constexpr size_t block_size = 16;
+    static constexpr size_t seed_size = key_size + block_size;
+    // largest request and reseed interval of table 3
+    static constexpr size_t max_request = 1 << 16;
+    static constexpr uint64_t reseed_interval = uint64_t(1) << 48;
+
+    // personalization of at most seed_size bytes
+    explicit CTR_DRBG(std::span<const uint8_t, seed_size> entropy,
+                      std::span<const uint8_t> personalization = {}) {
+        keys = AES::Common::expand_key(key256_t{key});
+        reseed(entropy, personalization);
+    }
+
+    CTR_DRBG(const CTR_DRBG &) = delete;
+    CTR_DRBG &operator=(const CTR_DRBG &) = delete;
+
+    ~CTR_DRBG() {
+        secure_zero(key.data(), key.size());
+        secure_zero(keys.data(), sizeof(keys));
+        secure_zero(v.data(), v.size());
+    }
+
+    // additional input of at most seed_size bytes
+    void reseed(std::span<const uint8_t, seed_size> entropy, std::span<const uint8_t> additional = {}) {
+        std::array<uint8_t, seed_size> seed;
+        std::copy(entropy.begin(), entropy.end(), seed.begin());
+        for (auto i = 0U; i < std::min(additional.size(), seed.size()); ++i) {
+            seed[i] ^= additional[i];
+        }
+        update(seed);
+        secure_zero(seed.data(), seed.size());
+        reseed_counter = 1;
+    }
+
+    bool needs_reseed() const { return reseed_counter > reseed_interval; }
+
+    // one request of at most max_request bytes. The keystream is written straight into output, only a
+    // partial last block goes through a buffer
+    void generate(std::span<uint8_t> output, std::span<const uint8_t> additional = {}) {
+        std::array<uint8_t, seed_size> provided{};
+        std::copy_n(additional.begin(), std::min(additional.size(), provided.size()), provided.begin());
+        if (!additional.empty()) {
+            update(provided);
+        }
+
+        CTR ctr{keys, v};
+        const auto whole = output.size() / block_size * block_size;
+        ctr.counter_blocks(1, output.first(whole));
+        AES::encrypt_blocks(output.first(whole), keys);
+        if (whole != output.size()) {
+            std::array<uint8_t, block_size> last;
+            ctr.counter_blocks(1 + whole / block_size, last);
+            AES::encrypt(block128_t{last}, keys);
+            std::copy_n(last.begin(), output.size() - whole, &output[whole]);
+            secure_zero(last.data(), last.size());
+        }
+        advance((output.size() + block_size - 1) / block_size);
+
+        update(provided);
+        ++reseed_counter;
+    }
+
+  private:
+    // CTR_DRBG_Update, the next seed_size bytes of keystream XOR provided become key and V
+    void update(std::span<const uint8_t, seed_size> provided) {
+        std::array<uint8_t, seed_size> temp;
+        CTR{keys, v}.counter_blocks(1, temp);
+        AES::encrypt_blocks(temp, keys);
+        for (auto i = 0U; i < temp.size(); ++i) {
+            temp[i] ^= provided[i];
+        }
+        std::copy_n(temp.begin(), key_size, key.begin());
+        std::copy_n(&temp[key_size], block_size, v.begin());
+        keys = AES::Common::expand_key(key256_t{key});
+        secure_zero(temp.data(), temp.size());
+    }
+
+    // V = V + blocks mod 2^128
+    void advance(uint64_t blocks) {
+        for (auto i = block_size; i-- > 0 && blocks != 0;) {
+            blocks += v[i];
+            v[i] = uint8_t(blocks);
+            blocks >>= 8;
+        }
+    }
+
+    std::array<uint8_t, key_size> key{};
+    std::array<state_t, 15> keys;
+    std::array<uint8_t, block_size> v{};
+    uint64_t reseed_counter = 0;
+};
+
+// one CTR_DRBG per thread, seeded from getrandom, with a buffer of output generated ahead. A request the
+// buffer can serve is a copy, bytes handed out are cleared from the buffer. The generator reseeds after
+// reseed_interval refills and after fork, so parent and child never share output.
+class Thread_Random {
+  public:
+    static constexpr size_t buffer_size = 16384;
+    static constexpr uint64_t reseed_interval = 1 << 14;
+
+    static void fill(std::span<uint8_t> output) {
+        auto &state = local();
+        if (state.fork_generation != fork_generation().load(std::memory_order_relaxed)) [[unlikely]] {
+            state.reseed();
+        }
+
+        while (!output.empty()) {
+            if (state.position == state.buffer.size()) {
+                // large requests skip the buffer
+                if (output.size() >= state.buffer.size()) {
+                    const auto size = std::min(output.size() / state.buffer.size() * state.buffer.size(),
+                                               CTR_DRBG::max_request);
+                    state.generate(output.first(size));
+                    output = output.subspan(size);
+                    continue;
+                }
+                state.refill();
+            }
+
+            const auto size = std::min(output.size(), state.buffer.size() - state.position);
+            std::memcpy(output.data(), &state.buffer[state.position], size);
+            secure_zero(&state.buffer[state.position], size);
+            state.position += size;
+            output = output.subspan(size);
+        }
+    }
+
+    // full entropy from the kernel, blocks until the pool is initialized
+    static void system_entropy(std::span<uint8_t> output) {
+        while (!output.empty()) {
+            const auto result = getrandom(output.data(), output.size(), 0);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::system_category(), "getrandom");
+            }
+            output = output.subspan(result);
+        }
+    }
+
+  private:
+    struct State {
+        CTR_DRBG drbg;
+        std::array<uint8_t, buffer_size> buffer;
+        size_t position = buffer_size;
+        uint64_t refills = 0;
+        uint64_t fork_generation;
+
+        State() : State(seed()) {}
+
+        explicit State(std::array<uint8_t, CTR_DRBG::seed_size> entropy)
+            : drbg(entropy), fork_generation(Thread_Random::fork_generation().load()) {
+            secure_zero(entropy.data(), entropy.size());
+        }
+
+        ~State() { secure_zero(buffer.data(), buffer.size()); }
+
+        static std::array<uint8_t, CTR_DRBG::seed_size> seed() {
+            std::array<uint8_t, CTR_DRBG::seed_size> entropy;
+            system_entropy(entropy);
+            return entropy;
+        }
+
+        void reseed() {
+            auto entropy = seed();
+            drbg.reseed(entropy);
+            secure_zero(entropy.data(), entropy.size());
+            secure_zero(buffer.data(), buffer.size());
+            position = buffer.size();
+            refills = 0;
+            fork_generation = Thread_Random::fork_generation().load();
+        }
+
+        void generate(std::span<uint8_t> output) {
+            if (++refills > reseed_interval || drbg.needs_reseed()) {
+                reseed();
+            }
+            drbg.generate(output);
+        }
+
+        void refill() {
+            generate(buffer);
+            position = 0;
+        }
+    };
+
+    static State &local() {
+        thread_local State state;
+        return state;
+    }
+
+    // incremented in the child after every fork, registered once per process
+    static std::atomic<uint64_t> &fork_generation() {
+        static std::atomic<uint64_t> generation = 0;
+        static const auto registered = pthread_atfork(nullptr, nullptr, [] { ++fork_generation(); });
+        (void)registered;
+        return generation;
+    }
+};
+} // namespace understanding_crypto::aes
+
+#endif
@@ -0,0 +1,404 @@
+#ifndef UNDERSTANDING_CRYPTO_DYNAMIC_UINT_H
+#define UNDERSTANDING_CRYPTO_DYNAMIC_UINT_H
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <understanding_crypto/biginteger.hpp>
+#include <understanding_crypto/modexp.hpp>
+#include <understanding_crypto/montgomery.hpp>
+
+namespace understanding_crypto {
+// bump allocator for limbs, one per thread. Memory comes in chunks that are kept once allocated, a Scope
+// rewinds to where it started, so a loop that allocates the same sizes in every round reuses the same
+// words and calls malloc only while the arena grows to its largest size
+class Limb_Arena {
+  public:
+    using value_t = size_t;
+    // 64 KiB, room for the temporaries of an 8192 bit modular exponentiation
+    static constexpr size_t chunk_words = 8192;
+
+    static Limb_Arena &local() {
+        thread_local Limb_Arena arena;
+        return arena;
+    }
+
+    // words that stay valid until the innermost Scope around the call ends, not initialized
+    std::span<value_t> allocate(size_t words) {
+        while (current < chunks.size() && chunks[current].size - used < words) {
+            ++current;
+            used = 0;
+        }
+        if (current == chunks.size()) {
+            const auto size = std::max(words, chunk_words);
+            chunks.push_back({std::make_unique_for_overwrite<value_t[]>(size), size});
+            used = 0;
+        }
+        const auto result = std::span<value_t>(chunks[current].words.get() + used, words);
+        used += words;
+        return result;
+    }
+
+    // words held by all chunks
+    size_t capacity() const {
+        size_t result = 0;
+        for (const auto &chunk : chunks) {
+            result += chunk.size;
+        }
+        return result;
+    }
+
+    // everything allocated while a Scope lives is released when it ends
+    class Scope {
+      public:
+        explicit Scope(Limb_Arena &arena = local())
+            : arena(arena), current(arena.current), used(arena.used) {}
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope() {
+            arena.current = current;
+            arena.used = used;
+        }
+
+      private:
+        Limb_Arena &arena;
+        size_t current;
+        size_t used;
+    };
+
+  private:
+    struct Chunk {
+        std::unique_ptr<value_t[]> words;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    // the chunk allocations come from and the words used in it
+    size_t current = 0;
+    size_t used = 0;
+};
+
+// unsigned integer with a width chosen at run time, for key sizes only known from the input. The limbs
+// live in a Limb_Arena and the arithmetic runs on the word kernels of uint_t, which do not depend on
+// BITS. A value must not outlive the Scope it was created in. Like uint_t the width of a value never
+// changes: the compound operators work modulo 2^(bits_in_word * word_count()), products and quotients
+// get a new value of the width they need
+class Dynamic_Uint {
+  public:
+    using kernels_t = uint_t<8 * sizeof(Limb_Arena::value_t)>;
+    using value_t = kernels_t::value_t;
+    using double_value_t = kernels_t::double_value_t;
+    static constexpr auto bits_in_word = kernels_t::bits_in_word;
+
+    // zero with the given number of words
+    explicit Dynamic_Uint(size_t words, Limb_Arena &arena = Limb_Arena::local())
+        : arena(&arena), internal_main(arena.allocate(std::max<size_t>(words, 1))) {
+        std::fill(internal_main.begin(), internal_main.end(), 0);
+    }
+
+    static Dynamic_Uint with_bits(size_t bits, Limb_Arena &arena = Limb_Arena::local()) {
+        return Dynamic_Uint((bits + bits_in_word - 1) / bits_in_word, arena);
+    }
+
+    template <size_t BITS>
+    explicit Dynamic_Uint(const uint_t<BITS> &x, Limb_Arena &arena = Limb_Arena::local())
+        : arena(&arena), internal_main(arena.allocate(x.word_count)) {
+        std::copy(x.internal_main.begin(), x.internal_main.end(), internal_main.begin());
+    }
+
+    Dynamic_Uint(const Dynamic_Uint &x) : arena(x.arena), internal_main(x.arena->allocate(x.word_count())) {
+        std::copy(x.internal_main.begin(), x.internal_main.end(), internal_main.begin());
+    }
+
+    // takes over the words of x without allocating, x is left without words
+    Dynamic_Uint(Dynamic_Uint &&x) noexcept : arena(x.arena), internal_main(x.internal_main) {
+        x.internal_main = {};
+    }
+
+    // keeps the width of this, x is cut or extended by zero words
+    Dynamic_Uint &operator=(const Dynamic_Uint &x) {
+        const auto copied = std::min(word_count(), x.word_count());
+        std::copy_n(x.internal_main.begin(), copied, internal_main.begin());
+        std::fill(internal_main.begin() + copied, internal_main.end(), 0);
+        return *this;
+    }
+
+    // the low BITS bits
+    template <size_t BITS> uint_t<BITS> to_uint() const {
+        uint_t<BITS> result{0};
+        const auto copied = std::min(word_count(), result.word_count);
+        std::copy_n(internal_main.begin(), copied, result.internal_main.begin());
+        result.trim();
+        return result;
+    }
+
+    size_t word_count() const { return internal_main.size(); }
+    std::span<value_t> words() { return internal_main; }
+    std::span<const value_t> words() const { return internal_main; }
+    value_t &operator[](size_t word_index) { return internal_main[word_index]; }
+    value_t operator[](size_t word_index) const { return internal_main[word_index]; }
+
+    // words without the leading zero words
+    size_t length() const {
+        auto result = word_count();
+        while (result > 0 && internal_main[result - 1] == 0) {
+            --result;
+        }
+        return result;
+    }
+
+    size_t bit_length() const {
+        const auto words = length();
+        return words == 0 ? 0 : (words - 1) * bits_in_word + std::bit_width(internal_main[words - 1]);
+    }
+
+    Dynamic_Uint &operator+=(const Dynamic_Uint &rhs) {
+        kernels_t::add_words(internal_main,
+                             rhs.internal_main.first(std::min(word_count(), rhs.word_count())));
+        return *this;
+    }
+
+    Dynamic_Uint &operator-=(const Dynamic_Uint &rhs) {
+        kernels_t::subtract_words(internal_main,
+                                  rhs.internal_main.first(std::min(word_count(), rhs.word_count())));
+        return *this;
+    }
+
+    Dynamic_Uint &operator<<=(size_t shift) {
+        kernels_t::shift_left_words(internal_main, shift);
+        return *this;
+    }
+
+    Dynamic_Uint &operator>>=(size_t shift) {
+        kernels_t::shift_right_words(internal_main, shift);
+        return *this;
+    }
+
+    // the full product, lhs.word_count() + rhs.word_count() words
+    friend Dynamic_Uint operator*(const Dynamic_Uint &lhs, const Dynamic_Uint &rhs) {
+        Dynamic_Uint result(lhs.word_count() + rhs.word_count(), *lhs.arena);
+        if (&lhs == &rhs) {
+            kernels_t::square_words(lhs.internal_main, result.internal_main);
+        } else {
+            kernels_t::multiply_words(lhs.internal_main, rhs.internal_main, result.internal_main);
+        }
+        return result;
+    }
+
+    // quotient with the width of lhs and remainder with the width of rhs, a zero rhs throws std::domain_error
+    friend Dynamic_Uint operator/(const Dynamic_Uint &lhs, const Dynamic_Uint &rhs) {
+        Dynamic_Uint quotient(lhs.word_count(), *lhs.arena);
+        {
+            Limb_Arena::Scope scope(*lhs.arena);
+            auto remainder = lhs.arena->allocate(rhs.word_count());
+            divide(lhs, rhs, quotient.internal_main, remainder);
+        }
+        return quotient;
+    }
+
+    friend Dynamic_Uint operator%(const Dynamic_Uint &lhs, const Dynamic_Uint &rhs) {
+        Dynamic_Uint remainder(rhs.word_count(), *lhs.arena);
+        {
+            Limb_Arena::Scope scope(*lhs.arena);
+            auto quotient = lhs.arena->allocate(lhs.word_count());
+            divide(lhs, rhs, quotient, remainder.internal_main);
+        }
+        return remainder;
+    }
+
+    // by value, the widths may differ
+    friend std::strong_ordering operator<=>(const Dynamic_Uint &lhs, const Dynamic_Uint &rhs) {
+        return kernels_t::compare_words(lhs.internal_main, rhs.internal_main) <=> 0;
+    }
+
+    friend bool operator==(const Dynamic_Uint &lhs, const Dynamic_Uint &rhs) {
+        return kernels_t::compare_words(lhs.internal_main, rhs.internal_main) == 0;
+    }
+
+    Limb_Arena &allocator() const { return *arena; }
+
+  private:
+    static void divide(const Dynamic_Uint &u, const Dynamic_Uint &v, std::span<value_t> quotient,
+                       std::span<value_t> remainder) {
+        Limb_Arena::Scope scope(*u.arena);
+        const auto scratch = u.arena->allocate(u.word_count() + v.word_count() + 1);
+        kernels_t::divide_words(u.internal_main, v.internal_main, quotient, remainder, scratch);
+    }
+
+    Limb_Arena *arena;
+    std::span<value_t> internal_main;
+};
+
+// Montgomery arithmetic like Montgomery<BITS> for a modulus whose width is known at run time, R is
+// 2^(bits_in_word * k) for the k significant words of n. The product and the reduction are separate
+// passes over a 2k + 1 word temporary from the arena of n. Values in Montgomery form have k words
+class Dynamic_Montgomery {
+  public:
+    using value_t = Dynamic_Uint::value_t;
+    using double_value_t = Dynamic_Uint::double_value_t;
+    using kernels_t = Dynamic_Uint::kernels_t;
+    static constexpr auto bits_in_word = Dynamic_Uint::bits_in_word;
+
+    // n odd
+    explicit Dynamic_Montgomery(const Dynamic_Uint &modulus)
+        : n(modulus.length(), modulus.allocator()), r2(modulus.length(), modulus.allocator()) {
+        n = modulus;
+        n_prime = 0 - word_inverse(n[0]);
+
+        // R^2 mod n by one division
+        Limb_Arena::Scope scope(modulus.allocator());
+        Dynamic_Uint power(2 * word_count() + 1, modulus.allocator());
+        power[2 * word_count()] = 1;
+        r2 = power % n;
+    }
+
+    size_t word_count() const { return n.word_count(); }
+    const Dynamic_Uint &modulus() const { return n; }
+
+    // a value of k words, zero
+    Dynamic_Uint make() const { return Dynamic_Uint(word_count(), n.allocator()); }
+
+    // out = a * b / R mod n for a and b below n of k words. out may be a or b
+    void mont_mul(const Dynamic_Uint &a, const Dynamic_Uint &b, Dynamic_Uint &out) const {
+        Limb_Arena::Scope scope(n.allocator());
+        const auto k = word_count();
+        const auto t = n.allocator().allocate(2 * k + 1);
+        if (&a == &b) {
+            kernels_t::square_words(a.words().first(k), t.first(2 * k));
+        } else {
+            kernels_t::multiply_words(a.words().first(k), b.words().first(k), t.first(2 * k));
+        }
+        reduce(t, out);
+    }
+
+    void mont_sqr(const Dynamic_Uint &a, Dynamic_Uint &out) const { mont_mul(a, a, out); }
+
+    // a below n of any width
+    Dynamic_Uint to_montgomery(const Dynamic_Uint &a) const {
+        auto result = make();
+        result = a;
+        mont_mul(result, r2, result);
+        return result;
+    }
+
+    Dynamic_Uint from_montgomery(const Dynamic_Uint &a) const {
+        auto result = make();
+        result = a;
+        {
+            Limb_Arena::Scope scope(n.allocator());
+            auto unit = make();
+            unit[0] = 1;
+            mont_mul(result, unit, result);
+        }
+        return result;
+    }
+
+    Dynamic_Uint one() const { return from_montgomery(r2); }
+
+  private:
+    // out = t / R mod n for t < n^2 of 2k words, t[2k] is scratch. Same rounds as Montgomery::mont_sqr
+    void reduce(std::span<value_t> t, Dynamic_Uint &out) const {
+        const auto k = word_count();
+        value_t top_carry = 0;
+        for (size_t i = 0; i < k; ++i) {
+            const value_t m = t[i] * n_prime;
+            double_value_t reduction = 0;
+            for (size_t j = 0; j < k; ++j) {
+                reduction += double_value_t(m) * n[j] + t[i + j];
+                t[i + j] = value_t(reduction);
+                reduction >>= bits_in_word;
+            }
+            reduction += double_value_t(t[i + k]) + top_carry;
+            t[i + k] = value_t(reduction);
+            top_carry = value_t(reduction >> bits_in_word);
+        }
+        t[2 * k] = top_carry;
+
+        // high < 2n, subtract n unless that borrows past the top word, the choice is made by a mask
+        const auto high = t.subspan(k, k + 1);
+        const auto difference = out.words().first(k);
+        std::copy_n(high.begin(), k, difference.begin());
+        const auto borrow = kernels_t::subtract_words(difference, n.words());
+        const value_t keep = 0 - value_t(borrow > high[k]);
+        for (size_t i = 0; i < k; ++i) {
+            difference[i] = (high[i] & keep) | (difference[i] & ~keep);
+        }
+        std::fill(out.words().begin() + k, out.words().end(), 0);
+    }
+
+    Dynamic_Uint n;
+    Dynamic_Uint r2;
+    value_t n_prime;
+};
+
+namespace modexp {
+// the w bits of x starting at bit position, positions past the end read as zero
+inline size_t window_at(const Dynamic_Uint &x, size_t position, size_t w) {
+    const auto word = position / x.bits_in_word;
+    const auto shift = position % x.bits_in_word;
+    Dynamic_Uint::value_t bits = word < x.word_count() ? x[word] >> shift : 0;
+    if (shift + w > x.bits_in_word && word + 1 < x.word_count()) {
+        bits |= x[word + 1] << (x.bits_in_word - shift);
+    }
+    return bits & ((Dynamic_Uint::value_t(1) << w) - 1);
+}
+} // namespace modexp
+
+// base^exponent mod n with a secret exponent, the fixed window method of pow_mod for uint_t over all
+// bits of the exponent width. The window table and every temporary come from the arena of n, after the
+// first call of a size the arena has grown enough and further calls do not allocate
+inline Dynamic_Uint pow_mod(const Dynamic_Montgomery &context, const Dynamic_Uint &base,
+                            const Dynamic_Uint &exponent) {
+    using value_t = Dynamic_Uint::value_t;
+    auto result = context.make();
+    {
+        Limb_Arena::Scope scope(context.modulus().allocator());
+        const auto exponent_bits = exponent.word_count() * exponent.bits_in_word;
+        const auto w = modexp::window_bits(exponent_bits);
+        const auto windows = (exponent_bits + w - 1) / w;
+        const auto k = context.word_count();
+
+        const auto words = context.modulus().allocator().allocate((size_t(1) << w) * k);
+        const auto entry = [&](size_t i) { return words.subspan(i * k, k); };
+        auto power = context.one();
+        std::copy_n(power.words().begin(), k, entry(0).begin());
+        const auto base_montgomery = context.to_montgomery(base);
+        for (size_t i = 1; i < (size_t(1) << w); ++i) {
+            context.mont_mul(power, base_montgomery, power);
+            std::copy_n(power.words().begin(), k, entry(i).begin());
+        }
+
+        auto selected = context.make();
+        const auto select = [&](size_t index) {
+            std::fill(selected.words().begin(), selected.words().end(), 0);
+            for (size_t i = 0; i < (size_t(1) << w); ++i) {
+                const value_t mask = value_t(0) - (value_t((i ^ index) - 1) >> (result.bits_in_word - 1));
+                for (size_t j = 0; j < k; ++j) {
+                    selected[j] |= entry(i)[j] & mask;
+                }
+            }
+        };
+
+        auto accumulator = context.make();
+        select(modexp::window_at(exponent, (windows - 1) * w, w));
+        accumulator = selected;
+        for (size_t window = windows - 1; window-- > 0;) {
+            for (size_t i = 0; i < w; ++i) {
+                context.mont_sqr(accumulator, accumulator);
+            }
+            select(modexp::window_at(exponent, window * w, w));
+            context.mont_mul(accumulator, selected, accumulator);
+        }
+        result = context.from_montgomery(accumulator);
+    }
+    return result;
+}
+} // namespace understanding_crypto
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef UNDERSTANDING_CRYPTO_GCD_H
+#define UNDERSTANDING_CRYPTO_GCD_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <understanding_crypto/biginteger.hpp>
+#include <understanding_crypto/montgomery.hpp>
+
+namespace understanding_crypto {
+namespace safegcd {
+// Bernstein and Yang, "Fast constant-time gcd computation and modular inversion". A divstep maps
+// (delta, f, g) with f odd to (1 - delta, g, (g - f) / 2) if delta > 0 and g is odd, else to
+// (1 + delta, f, (g + (g mod 2) f) / 2). From (f, g) = (n, x) enough divsteps reach g = 0 and
+// f = +-gcd(n, x). The divsteps of a batch only look at the low bits of f and g, so they run on one
+// word and build a 2x2 matrix that is applied to the whole numbers once per batch.
+constexpr size_t steps_per_batch = 62;
+
+// divsteps needed for inputs below 2^bits, theorem 11.2 of the paper
+constexpr size_t iterations(size_t bits) {
+    return bits < 46 ? (49 * bits + 80) / 17 : (49 * bits + 57) / 17;
+}
+
+// 2^62 (f', g') = (u f + v g, q f + r g), |u| + |v| <= 2^62 and |q| + |r| <= 2^62
+struct Transition {
+    int64_t u, v, q, r;
+};
+
+// steps_per_batch divsteps on the low words of f and g without a branch on them, returns delta
+constexpr int64_t divsteps(int64_t delta, uint64_t f, uint64_t g, Transition &transition) {
+    uint64_t u = 1, v = 0, q = 0, r = 1;
+    for (size_t i = 0; i < steps_per_batch; ++i) {
+        // all ones when delta > 0 and g is odd: (f, g, u, v, q, r) becomes (g, -f, q, r, -u, -v)
+        const auto swap = uint64_t((0 - delta) >> 63) & (0 - (g & 1));
+        const auto exchange = [swap](uint64_t &x, uint64_t &y) {
+            const auto difference = (x ^ y) & swap;
+            x ^= difference;
+            y = ((y ^ difference) ^ swap) - swap;
+        };
+        exchange(f, g);
+        exchange(u, q);
+        exchange(v, r);
+        delta = (delta ^ int64_t(swap)) - int64_t(swap);
+
+        const auto odd = 0 - (g & 1);
+        g = (g + (f & odd)) >> 1;
+        q += u & odd;
+        r += v & odd;
+        u <<= 1;
+        v <<= 1;
+        ++delta;
+    }
+    transition = {int64_t(u), int64_t(v), int64_t(q), int64_t(r)};
+    return delta;
+}
+
+// the same transition with branches: runs of zero bits of g are skipped at once
+constexpr int64_t divsteps_variable(int64_t delta, uint64_t f, uint64_t g, Transition &transition) {
+    uint64_t u = 1, v = 0, q = 0, r = 1;
+    for (size_t left = steps_per_batch;;) {
+        const auto zeros = std::min<size_t>(std::countr_zero(g), left);
+        g >>= zeros;
+        u <<= zeros;
+        v <<= zeros;
+        delta += int64_t(zeros);
+        left -= zeros;
+        if (left == 0) {
+            break;
+        }
+        // g is odd, the divstep adds f and the next round of zeros divides by two
+        if (delta > 0) {
+            delta = -delta;
+            std::swap(f, g);
+            std::swap(u, q);
+            std::swap(v, r);
+            g = 0 - g;
+            q = 0 - q;
+            r = 0 - r;
+        }
+        g += f;
+        q += u;
+        r += v;
+    }
+    transition = {int64_t(u), int64_t(v), int64_t(q), int64_t(r)};
+    return delta;
+}
+
+// signed numbers of W words in two's complement
+template <size_t W> using words_t = std::array<uint64_t, W>;
+
+// (u a + v b + m c) / 2^62 for a sum divisible by 2^62 whose quotient fits W words, c not negative. The
+// products with m get their own accumulator, |m c[i]| alone almost fills 128 bits
+template <bool with_c, size_t W>
+constexpr void combine(words_t<W> &out, const words_t<W> &a, const words_t<W> &b, int64_t u, int64_t v,
+                       const words_t<W> &c, int64_t m) {
+    __extension__ using wide_t = __int128;
+    words_t<W + 1> sum;
+    wide_t products = 0, modulus_products = 0, carry = 0;
+    for (size_t i = 0; i < W; ++i) {
+        // the top word carries the sign
+        const auto a_word = i + 1 < W ? wide_t(a[i]) : wide_t(int64_t(a[i]));
+        const auto b_word = i + 1 < W ? wide_t(b[i]) : wide_t(int64_t(b[i]));
+        products += u * a_word + v * b_word;
+        if constexpr (with_c) {
+            modulus_products += wide_t(m) * c[i];
+        }
+        carry += wide_t(uint64_t(products)) + uint64_t(modulus_products);
+        sum[i] = uint64_t(carry);
+        carry >>= 64;
+        products >>= 64;
+        modulus_products >>= 64;
+    }
+    sum[W] = uint64_t(products + modulus_products + carry);
+    for (size_t i = 0; i < W; ++i) {
+        out[i] = sum[i] >> steps_per_batch | sum[i + 1] << (64 - steps_per_batch);
+    }
+}
+
+// x = -x where mask is all ones, x unchanged where it is zero
+template <size_t W> constexpr void negate_if(words_t<W> &x, uint64_t mask) {
+    uint64_t carry = mask & 1;
+    for (auto &word : x) {
+        word = (word ^ mask) + carry;
+        carry = uint64_t(word < carry);
+    }
+}
+
+// x += c where mask is all ones
+template <size_t W> constexpr void add_if(words_t<W> &x, const words_t<W> &c, uint64_t mask) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < W; ++i) {
+        const auto sum = x[i] + (c[i] & mask);
+        const auto word = sum + carry;
+        carry = uint64_t(sum < x[i]) | uint64_t(word < sum);
+        x[i] = word;
+    }
+}
+
+template <size_t W> constexpr uint64_t sign_mask(const words_t<W> &x) {
+    return uint64_t(int64_t(x[W - 1]) >> 63);
+}
+
+template <size_t BITS> constexpr size_t trailing_zeros(const uint_t<BITS> &x) {
+    for (size_t i = 0; i < x.word_count; ++i) {
+        if (x[i] != 0) {
+            return i * x.bits_in_word + std::countr_zero(x[i]);
+        }
+    }
+    return BITS;
+}
+
+// x^-1 mod n for an odd n and x below n from the divsteps of (n, x): d x = f and e x = g mod n hold for
+// the coefficients d and e, which see the same matrices as f and g. Their division by 2^62 is made
+// exact by adding a multiple of n first. The constant time version runs the batches the bound asks for
+// on every input, the variable time one stops when g is zero
+template <bool constant_time, size_t BITS>
+constexpr std::optional<uint_t<BITS>> inverse(const uint_t<BITS> &x, const uint_t<BITS> &n) {
+    // one spare word for the sign and for d, e in (-2n, n)
+    constexpr auto W = uint_t<BITS>::word_count + 1;
+    constexpr auto low_bits = (uint64_t(1) << steps_per_batch) - 1;
+
+    words_t<W> f{}, g{}, d{}, e{}, modulus{};
+    std::copy(n.internal_main.begin(), n.internal_main.end(), f.begin());
+    std::copy(x.internal_main.begin(), x.internal_main.end(), g.begin());
+    modulus = f;
+    e[0] = 1;
+
+    const auto n_inverse = word_inverse(uint64_t(n[0]));
+
+    const auto is_zero = [](const words_t<W> &y) {
+        return std::all_of(y.begin(), y.end(), [](uint64_t word) { return word == 0; });
+    };
+    int64_t delta = 1;
+    Transition t;
+    for (size_t batch = 0; batch < (iterations(BITS) + steps_per_batch - 1) / steps_per_batch; ++batch) {
+        if constexpr (constant_time) {
+            delta = divsteps(delta, f[0], g[0], t);
+        } else {
+            if (is_zero(g)) {
+                break;
+            }
+            delta = divsteps_variable(delta, f[0], g[0], t);
+        }
+        const auto f_old = f;
+        combine<false>(f, f_old, g, t.u, t.v, modulus, 0);
+        combine<false>(g, f_old, g, t.q, t.r, modulus, 0);
+
+        // the multiples of n keep d and e in (-2n, n) and make the low 62 bits of the sums zero
+        const auto d_negative = sign_mask(d), e_negative = sign_mask(e);
+        auto m_d = (t.u & int64_t(d_negative)) + (t.v & int64_t(e_negative));
+        auto m_e = (t.q & int64_t(d_negative)) + (t.r & int64_t(e_negative));
+        const auto low_d = uint64_t(t.u) * d[0] + uint64_t(t.v) * e[0];
+        const auto low_e = uint64_t(t.q) * d[0] + uint64_t(t.r) * e[0];
+        m_d -= int64_t((n_inverse * low_d + uint64_t(m_d)) & low_bits);
+        m_e -= int64_t((n_inverse * low_e + uint64_t(m_e)) & low_bits);
+        const auto d_old = d;
+        combine<true>(d, d_old, e, t.u, t.v, modulus, m_d);
+        combine<true>(e, d_old, e, t.q, t.r, modulus, m_e);
+    }
+
+    // g = 0 now and f = +-gcd(x, n). d x = f mod n, bring d from (-2n, n) to [0, n) and fix the sign
+    const auto f_negative = sign_mask(f);
+    add_if(d, modulus, sign_mask(d));
+    negate_if(d, f_negative);
+    add_if(d, modulus, sign_mask(d));
+    negate_if(f, f_negative);
+    uint64_t not_one = f[0] ^ 1;
+    for (size_t i = 1; i < W; ++i) {
+        not_one |= f[i];
+    }
+    if (not_one != 0) {
+        return std::nullopt;
+    }
+    uint_t<BITS> result{0};
+    std::copy_n(d.begin(), result.word_count, result.internal_main.begin());
+    return result;
+}
+} // namespace safegcd
+
+// x^-1 mod n for an odd n and x below n, nothing when gcd(x, n) is not 1. Constant time: a fixed number
+// of divstep batches for BITS, the divsteps and the updates without a branch on the values
+template <size_t BITS>
+constexpr std::optional<uint_t<BITS>> inverse_mod(const uint_t<BITS> &x, const uint_t<BITS> &n) {
+    return safegcd::inverse<true>(x, n);
+}
+
+// gcd(a, b) by Stein's binary algorithm, variable time for public inputs. gcd(0, 0) = 0
+template <size_t BITS> constexpr uint_t<BITS> gcd(uint_t<BITS> a, uint_t<BITS> b) {
+    const uint_t<BITS> zero{0};
+    if (a == zero) {
+        return b;
+    }
+    if (b == zero) {
+        return a;
+    }
+    const auto a_zeros = safegcd::trailing_zeros(a), b_zeros = safegcd::trailing_zeros(b);
+    a >>= a_zeros;
+    while (true) {
+        b >>= safegcd::trailing_zeros(b);
+        if (a > b) {
+            std::swap(a, b);
+        }
+        b -= a;
+        if (b == zero) {
+            return a <<= std::min(a_zeros, b_zeros);
+        }
+    }
+}
+
+// x^-1 mod n for public inputs like e in RSA, variable time, nothing when gcd(x, n) is not 1. The divsteps
+// skip runs of zero bits and stop once g is zero, for random inputs after about two thirds of the
+// batches of the bound. An even n is handled through the odd x: with t = n^-1 mod x, (1 + n (x - t)) / x
+// is the inverse of x mod n. There is no binary extended gcd beside it: the inverse is what the callers need,
+// and the variable time divsteps give it without signed Bezout coefficients
+template <size_t BITS>
+constexpr std::optional<uint_t<BITS>> inverse_mod_public(const uint_t<BITS> &x, const uint_t<BITS> &n) {
+    using number_t = uint_t<BITS>;
+    const number_t zero{0}, one{1};
+    if (n == zero) {
+        return std::nullopt;
+    }
+    if (n == one) {
+        return zero;
+    }
+    const number_t a = x % n;
+    if (a == one) {
+        return one;
+    }
+    if ((n[0] & 1) != 0) {
+        return safegcd::inverse<false>(a, n);
+    }
+    if ((a[0] & 1) == 0) {
+        return std::nullopt;
+    }
+    const auto t = inverse_mod_public(n % a, a);
+    if (!t) {
+        return std::nullopt;
+    }
+    auto numerator = uint_t<2 * BITS>::from_multiplication_of(n, number_t(a - *t));
+    numerator += 1U;
+    return number_t(numerator / a);
+}
+} // namespace understanding_crypto
+
+#endif
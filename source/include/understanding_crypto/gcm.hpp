@@ -0,0 +1,471 @@
+#ifndef UNDERSTANDING_CRYPTO_GCM_H
+#define UNDERSTANDING_CRYPTO_GCM_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include <understanding_crypto/aes.hpp>
+#include <understanding_crypto/cpu.hpp>
+#include <understanding_crypto/ctr.hpp>
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+#include <immintrin.h>
+#endif
+
+namespace understanding_crypto::aes {
+// the universal hash of GCM (NIST SP 800-38D), multiplication by H in GF(2^128) with the bit reflected
+// polynomial x^128 + x^7 + x^2 + x + 1
+class GHASH {
+  public:
+    static constexpr size_t block_size = 16;
+    static constexpr size_t aggregated_blocks = 8;
+
+    // bytes 0..7 and 8..15 of a block, big endian
+    struct element_t {
+        uint64_t high = 0;
+        uint64_t low = 0;
+
+        constexpr element_t &operator^=(const element_t &rhs) {
+            high ^= rhs.high;
+            low ^= rhs.low;
+            return *this;
+        }
+        constexpr bool operator==(const element_t &) const = default;
+    };
+
+    explicit GHASH(const element_t &h) {
+        // Shoup's 4 bit table, table[i] holds i * H where bit 3 of i is the first coefficient
+        table[8] = h;
+        for (auto i = 4U; i > 0; i >>= 1) {
+            table[i] = multiply_x(table[2 * i]);
+        }
+        for (auto i = 2U; i <= 8; i *= 2) {
+            for (auto j = 1U; j < i; ++j) {
+                table[i + j] = table[i];
+                table[i + j] ^= table[j];
+            }
+        }
+
+        powers[0] = h;
+        for (auto i = 1U; i < powers.size(); ++i) {
+            powers[i] = multiply(powers[i - 1]);
+        }
+    }
+
+    static element_t load(std::span<const uint8_t, block_size> block) {
+        element_t result;
+        for (auto i = 0U; i < 8; ++i) {
+            result.high = (result.high << 8) | block[i];
+            result.low = (result.low << 8) | block[i + 8];
+        }
+        return result;
+    }
+
+    static void store(const element_t &element, std::span<uint8_t, block_size> block) {
+        for (auto i = 0U; i < 8; ++i) {
+            block[i] = element.high >> (56 - 8 * i);
+            block[i + 8] = element.low >> (56 - 8 * i);
+        }
+    }
+
+    // Y = (Y + X_i) * H over all blocks of data, a partial last block is padded with zeros
+    void absorb(element_t &y, std::span<const uint8_t> data) const {
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (clmul_supported()) {
+            const auto done = absorb_clmul(y, data);
+            data = data.subspan(done);
+        }
+#endif
+        while (!data.empty()) {
+            std::array<uint8_t, block_size> block{};
+            const auto length = std::min(block_size, data.size());
+            std::copy_n(data.begin(), length, block.begin());
+            y ^= load(block);
+            y = multiply(y);
+            data = data.subspan(length);
+        }
+    }
+
+    // x * H with the table, 32 lookups per block
+    element_t multiply(const element_t &x) const {
+        element_t z{};
+        for (auto i = 15; i >= 0; --i) {
+            const auto byte = uint8_t(i < 8 ? x.high >> (56 - 8 * i) : x.low >> (120 - 8 * i));
+            if (i != 15) {
+                shift_nibble(z);
+            }
+            z ^= table[byte & 0xF];
+            shift_nibble(z);
+            z ^= table[byte >> 4];
+        }
+        return z;
+    }
+
+    // H^(n + 1)
+    const element_t &power(size_t n) const { return powers[n]; }
+
+    // H^n for any n, by squaring
+    element_t power_of_h(uint64_t n) const {
+        element_t result{0x8000000000000000ULL, 0};
+        auto square = powers[0];
+        for (; n != 0; n >>= 1) {
+            if (n & 1) {
+                result = multiply(result, square);
+            }
+            square = multiply(square, square);
+        }
+        return result;
+    }
+
+    // a * b one bit at a time, for the few products that are not with H. The operands are powers of H
+    // and partial hashes, so the bits of a select b by a mask instead of a branch
+    static constexpr element_t multiply(const element_t &a, element_t b) {
+        element_t z{};
+        for (auto i = 0U; i < 128; ++i) {
+            const auto bit = i < 64 ? (a.high >> (63 - i)) & 1 : (a.low >> (127 - i)) & 1;
+            const auto mask = 0 - bit;
+            z ^= element_t{b.high & mask, b.low & mask};
+            b = multiply_x(b);
+        }
+        return z;
+    }
+
+    static constexpr element_t multiply_x(const element_t &v) {
+        const auto reduce = (v.low & 1) * 0xE100000000000000ULL;
+        return {(v.high >> 1) ^ reduce, (v.high << 63) | (v.low >> 1)};
+    }
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+    static bool clmul_supported() {
+        const auto &features = cpu::features();
+        return features.pclmul && features.ssse3 && features.sse41;
+    }
+
+    // elements keep their integer value in the register, which is the byte reversed block
+    [[gnu::target("sse2")]] static __m128i to_register(const element_t &element) {
+        return _mm_set_epi64x(element.high, element.low);
+    }
+
+    [[gnu::target("sse4.1")]] static element_t from_register(__m128i value) {
+        return {uint64_t(_mm_extract_epi64(value, 1)), uint64_t(_mm_cvtsi128_si64(value))};
+    }
+
+    [[gnu::target("ssse3")]] static __m128i load_reversed(const uint8_t *block) {
+        const auto reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(block)), reverse);
+    }
+
+    // 256 bit carry-less product, added to low and high without reduction
+    [[gnu::target("pclmul")]]
+    static void multiply_accumulate(__m128i a, __m128i b, __m128i &low, __m128i &high) {
+        const auto middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+        low = _mm_xor_si128(low, _mm_clmulepi64_si128(a, b, 0x00));
+        low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+        high = _mm_xor_si128(high, _mm_clmulepi64_si128(a, b, 0x11));
+        high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+    }
+
+    // the product of two reflected values is one bit short, shift it left before reducing
+    // (Intel carry-less multiplication white paper, algorithm 5)
+    [[gnu::target("sse2")]] static __m128i reduce(__m128i low, __m128i high) {
+        auto carry_low = _mm_srli_epi32(low, 31);
+        auto carry_high = _mm_srli_epi32(high, 31);
+        low = _mm_slli_epi32(low, 1);
+        high = _mm_slli_epi32(high, 1);
+        const auto carry_across = _mm_srli_si128(carry_low, 12);
+        carry_high = _mm_slli_si128(carry_high, 4);
+        carry_low = _mm_slli_si128(carry_low, 4);
+        low = _mm_or_si128(low, carry_low);
+        high = _mm_or_si128(_mm_or_si128(high, carry_high), carry_across);
+
+        auto fold = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)),
+                                  _mm_slli_epi32(low, 25));
+        const auto fold_high = _mm_srli_si128(fold, 4);
+        fold = _mm_slli_si128(fold, 12);
+        low = _mm_xor_si128(low, fold);
+
+        auto result = _mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2));
+        result = _mm_xor_si128(result, _mm_srli_epi32(low, 7));
+        result = _mm_xor_si128(result, fold_high);
+        return _mm_xor_si128(high, _mm_xor_si128(low, result));
+    }
+
+    // H^n first, down to H, loaded once per call and kept in registers
+    [[gnu::target("sse2")]] void load_powers(__m128i (&registers)[aggregated_blocks]) const {
+        for (auto i = 0U; i < aggregated_blocks; ++i) {
+            registers[i] = to_register(powers[aggregated_blocks - 1 - i]);
+        }
+    }
+
+    // aggregated reduction: Y' = (Y + X_1) * H^n + X_2 * H^(n-1) + ... + X_n * H,
+    // only one reduction per n blocks
+    [[gnu::target("pclmul,ssse3,sse4.1")]]
+    static void absorb_blocks(__m128i &hash, const __m128i (&blocks)[aggregated_blocks],
+                              const __m128i (&descending_powers)[aggregated_blocks]) {
+        auto low = _mm_setzero_si128();
+        auto high = _mm_setzero_si128();
+        for (auto i = 0U; i < aggregated_blocks; ++i) {
+            const auto block = i == 0 ? _mm_xor_si128(hash, blocks[0]) : blocks[i];
+            multiply_accumulate(block, descending_powers[i], low, high);
+        }
+        hash = reduce(low, high);
+    }
+
+    // returns the number of bytes absorbed, whole blocks only
+    [[gnu::target("pclmul,ssse3,sse4.1")]]
+    size_t absorb_clmul(element_t &y, std::span<const uint8_t> data) const {
+        constexpr auto group_size = aggregated_blocks * block_size;
+        __m128i descending_powers[aggregated_blocks];
+        load_powers(descending_powers);
+        auto hash = to_register(y);
+        size_t offset = 0;
+        for (; offset + group_size <= data.size(); offset += group_size) {
+            __m128i blocks[aggregated_blocks];
+            for (auto i = 0U; i < aggregated_blocks; ++i) {
+                blocks[i] = load_reversed(&data[offset + i * block_size]);
+            }
+            absorb_blocks(hash, blocks, descending_powers);
+        }
+
+        const auto h = to_register(powers[0]);
+        for (; offset + block_size <= data.size(); offset += block_size) {
+            auto low = _mm_setzero_si128();
+            auto high = _mm_setzero_si128();
+            multiply_accumulate(_mm_xor_si128(hash, load_reversed(&data[offset])), h, low, high);
+            hash = reduce(low, high);
+        }
+        y = from_register(hash);
+        return offset;
+    }
+#endif
+
+  private:
+    // z * x^4, the four bits shifted out are reduced with the precomputed multiples of the polynomial
+    static void shift_nibble(element_t &z) {
+        constexpr std::array<uint64_t, 16> reduction = {0x0000, 0x1C20, 0x3840, 0x2460, 0x7080, 0x6CA0,
+                                                        0x48C0, 0x54E0, 0xE100, 0xFD20, 0xD940, 0xC560,
+                                                        0x9180, 0x8DA0, 0xA9C0, 0xB5E0};
+        const auto remainder = z.low & 0xF;
+        z.low = (z.high << 60) | (z.low >> 4);
+        z.high = (z.high >> 4) ^ (reduction[remainder] << 48);
+    }
+
+    std::array<element_t, 16> table{};
+    std::array<element_t, aggregated_blocks> powers{};
+};
+
+// Galois/counter mode (NIST SP 800-38D) with 16 byte tags. Encryption and authentication run in one pass over
+// the data. The expanded keys are referenced and cannot be a temporary.
+template <typename expanded_keys_t> class GCM {
+  public:
+    static constexpr size_t block_size = 16;
+    static constexpr size_t tag_size = 16;
+    using block_t = std::array<uint8_t, block_size>;
+
+    explicit GCM(const expanded_keys_t &keys) : keys(keys), bulk_keys(keys), ghash(hash_key(keys)) {}
+    explicit GCM(const expanded_keys_t &&) = delete;
+
+    // cipher has to be at least as long as plain and may be the same memory
+    void encrypt(std::span<const uint8_t> iv, std::span<const uint8_t> aad, std::span<const uint8_t> plain,
+                 std::span<uint8_t> cipher, std::span<uint8_t, tag_size> tag) const {
+        const auto j0 = initial_counter(iv);
+        GHASH::element_t y{};
+        ghash.absorb(y, aad);
+        process_segment<true>(j0, 0, plain, cipher, y);
+        finish(j0, y, aad.size(), plain.size(), tag);
+    }
+
+    // returns false and clears plain if the tag does not match
+    bool decrypt(std::span<const uint8_t> iv, std::span<const uint8_t> aad, std::span<const uint8_t> cipher,
+                 std::span<uint8_t> plain, std::span<const uint8_t, tag_size> tag) const {
+        const auto j0 = initial_counter(iv);
+        GHASH::element_t y{};
+        ghash.absorb(y, aad);
+        process_segment<false>(j0, 0, cipher, plain, y);
+
+        block_t expected;
+        finish(j0, y, aad.size(), cipher.size(), expected);
+        if (!tags_equal(expected, tag)) {
+            std::fill_n(plain.begin(), cipher.size(), 0);
+            return false;
+        }
+        return true;
+    }
+
+    // counter mode over a segment of the data that starts at block index, the ciphertext is hashed into y.
+    // Segments other than the last have to be whole blocks. Hashing a later segment from y = 0 and folding it
+    // in with H^n gives the same result as one pass, which is how the segments can run in parallel.
+    template <bool encrypting>
+    void process_segment(const block_t &j0, size_t index, std::span<const uint8_t> input,
+                         std::span<uint8_t> output, GHASH::element_t &y) const {
+        size_t done = 0;
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (fused_supported()) {
+            done = crypt_fused<encrypting>(j0, index, input, output, y);
+        }
+#endif
+        if constexpr (encrypting) {
+            crypt(j0, index + done / block_size, input.subspan(done), output.subspan(done));
+            ghash.absorb(y, output.subspan(done, input.size() - done));
+        } else {
+            ghash.absorb(y, input.subspan(done));
+            crypt(j0, index + done / block_size, input.subspan(done), output.subspan(done));
+        }
+    }
+
+    // adds the lengths and the encrypted J0 to the hash
+    void finish(const block_t &j0, GHASH::element_t &y, size_t aad_size, size_t data_size,
+                std::span<uint8_t, tag_size> tag) const {
+        y ^= GHASH::element_t{uint64_t(aad_size) * 8, uint64_t(data_size) * 8};
+        y = ghash.multiply(y);
+
+        auto block = j0;
+        AES::encrypt(block128_t{block}, keys);
+        y ^= GHASH::load(block);
+        GHASH::store(y, tag);
+    }
+
+    // constant time
+    static bool tags_equal(std::span<const uint8_t, tag_size> a, std::span<const uint8_t, tag_size> b) {
+        uint8_t difference = 0;
+        for (auto i = 0U; i < tag_size; ++i) {
+            difference |= a[i] ^ b[i];
+        }
+        return difference == 0;
+    }
+
+    // J0, the counter block that encrypts the tag, the data starts at inc32(J0)
+    block_t initial_counter(std::span<const uint8_t> iv) const {
+        block_t j0{};
+        if (iv.size() == 12) {
+            std::copy(iv.begin(), iv.end(), j0.begin());
+            j0[15] = 1;
+        } else {
+            GHASH::element_t y{};
+            ghash.absorb(y, iv);
+            y ^= GHASH::element_t{0, uint64_t(iv.size()) * 8};
+            GHASH::store(ghash.multiply(y), j0);
+        }
+        return j0;
+    }
+
+    const GHASH &hash() const { return ghash; }
+
+  private:
+    static GHASH::element_t hash_key(const expanded_keys_t &keys) {
+        block_t zero{};
+        AES::encrypt(block128_t{zero}, keys);
+        return GHASH::load(zero);
+    }
+
+    // counter mode starting at block index + 1 after J0, only the last 32 bits count
+    void crypt(const block_t &j0, size_t index, std::span<const uint8_t> input,
+               std::span<uint8_t> output) const {
+        constexpr size_t batch_blocks = CTR<expanded_keys_t>::batch_blocks;
+        std::array<uint8_t, batch_blocks * block_size> keystream;
+
+        auto next = uint32_t(GHASH::load(j0).low) + 1 + uint32_t(index);
+        while (!input.empty()) {
+            const auto block_count = std::min(batch_blocks, (input.size() + block_size - 1) / block_size);
+            const auto length = std::min(input.size(), block_count * block_size);
+
+            for (auto offset = 0U; offset < length; offset += block_size) {
+                std::copy_n(j0.begin(), block_size - sizeof(next), &keystream[offset]);
+                store_counter(next++, &keystream[offset + block_size - sizeof(next)]);
+            }
+            AES::encrypt_blocks(std::span(keystream).first(block_count * block_size), bulk_keys);
+
+            for (auto i = 0U; i < length; ++i) {
+                output[i] = input[i] ^ keystream[i];
+            }
+            input = input.subspan(length);
+            output = output.subspan(length);
+        }
+    }
+
+    static void store_counter(uint32_t counter, uint8_t *bytes) {
+        if constexpr (std::endian::native == std::endian::little) {
+            counter = std::byteswap(counter);
+        }
+        std::memcpy(bytes, &counter, sizeof(counter));
+    }
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+    static bool fused_supported() { return AES::AESNI::supported() && GHASH::clmul_supported(); }
+
+    // AES-NI counter mode and the aggregated GHASH of the ciphertext share one loop over 8 blocks,
+    // returns the number of bytes processed
+    template <bool encrypting>
+    [[gnu::target("aes,pclmul,ssse3,sse4.1")]]
+    size_t crypt_fused(const block_t &j0, size_t index, std::span<const uint8_t> input,
+                       std::span<uint8_t> output, GHASH::element_t &y) const {
+        constexpr auto rounds = round_key_count<expanded_keys_t>;
+        constexpr auto lanes = GHASH::aggregated_blocks;
+        const auto &encryption_keys = AES::Common::encryption_keys(keys);
+        __m128i round_keys[rounds];
+        for (auto i = 0U; i < rounds; ++i) {
+            round_keys[i] = AES::AESNI::load_state(encryption_keys[i]);
+        }
+
+        const auto reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        const auto base = _mm_loadu_si128(reinterpret_cast<const __m128i *>(j0.data()));
+        auto next = uint32_t(GHASH::load(j0).low) + 1 + uint32_t(index);
+        auto hash = GHASH::to_register(y);
+        __m128i descending_powers[lanes];
+        ghash.load_powers(descending_powers);
+
+        size_t offset = 0;
+        for (; offset + lanes * block_size <= input.size(); offset += lanes * block_size) {
+            __m128i x[lanes];
+            __m128i data[lanes];
+            for (auto j = 0U; j < lanes; ++j) {
+                x[j] = _mm_insert_epi32(base, int(__builtin_bswap32(next + j)), 3);
+                x[j] = _mm_xor_si128(x[j], round_keys[0]);
+                data[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&input[offset + j * block_size]));
+            }
+            next += lanes;
+
+            __m128i ciphertext[lanes];
+            if constexpr (!encrypting) {
+                for (auto j = 0U; j < lanes; ++j) {
+                    ciphertext[j] = _mm_shuffle_epi8(data[j], reverse);
+                }
+                GHASH::absorb_blocks(hash, ciphertext, descending_powers);
+            }
+
+#pragma GCC unroll 16
+            for (auto i = 1U; i < rounds - 1; ++i) {
+                for (auto &block : x) {
+                    block = _mm_aesenc_si128(block, round_keys[i]);
+                }
+            }
+            for (auto j = 0U; j < lanes; ++j) {
+                x[j] = _mm_xor_si128(_mm_aesenclast_si128(x[j], round_keys[rounds - 1]), data[j]);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&output[offset + j * block_size]), x[j]);
+            }
+
+            if constexpr (encrypting) {
+                for (auto j = 0U; j < lanes; ++j) {
+                    ciphertext[j] = _mm_shuffle_epi8(x[j], reverse);
+                }
+                GHASH::absorb_blocks(hash, ciphertext, descending_powers);
+            }
+        }
+
+        y = GHASH::from_register(hash);
+        return offset;
+    }
+#endif
+
+    const expanded_keys_t &keys;
+    AES::Bulk_Keys<expanded_keys_t> bulk_keys;
+    GHASH ghash;
+};
+} // namespace understanding_crypto::aes
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef UNDERSTANDING_CRYPTO_MODEXP_H
+#define UNDERSTANDING_CRYPTO_MODEXP_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+
+#include <understanding_crypto/biginteger.hpp>
+#include <understanding_crypto/montgomery.hpp>
+
+namespace understanding_crypto {
+namespace modexp {
+// window bits by exponent length, the table of 2^w powers costs 2^w multiplications up front and saves
+// one multiplication every w bits
+constexpr size_t window_bits(size_t exponent_bits) {
+    return exponent_bits <= 512 ? 4 : exponent_bits <= 2048 ? 5 : 6;
+}
+
+// the w bits of x starting at bit position, positions past the end read as zero
+template <size_t BITS> constexpr size_t window_at(const uint_t<BITS> &x, size_t position, size_t w) {
+    using value_t = typename uint_t<BITS>::value_t;
+    constexpr auto bits_in_word = uint_t<BITS>::bits_in_word;
+    const auto word = position / bits_in_word;
+    const auto shift = position % bits_in_word;
+    value_t bits = word < x.word_count ? x[word] >> shift : 0;
+    if (shift + w > bits_in_word && word + 1 < x.word_count) {
+        bits |= x[word + 1] << (bits_in_word - shift);
+    }
+    return bits & ((value_t(1) << w) - 1);
+}
+
+template <size_t BITS> constexpr size_t bit_length(const uint_t<BITS> &x) {
+    for (size_t i = x.word_count; i-- > 0;) {
+        if (x[i] != 0) {
+            return i * x.bits_in_word + std::bit_width(x[i]);
+        }
+    }
+    return 0;
+}
+} // namespace modexp
+
+// base^exponent mod n with the exponent secret. Fixed windows of w bits over all EXPONENT_BITS: w squarings
+// and one multiplication per window whatever the bits are, and every table read scans the whole table
+// with masks, so neither the sequence of operations nor the accessed memory depends on the exponent.
+// base is in the normal representation and below n
+template <size_t BITS, size_t EXPONENT_BITS>
+constexpr uint_t<BITS> pow_mod(const Montgomery<BITS> &context, const uint_t<BITS> &base,
+                               const uint_t<EXPONENT_BITS> &exponent) {
+    using number_t = uint_t<BITS>;
+    using value_t = typename number_t::value_t;
+    constexpr auto w = modexp::window_bits(EXPONENT_BITS);
+    constexpr auto windows = (EXPONENT_BITS + w - 1) / w;
+
+    std::array<number_t, size_t(1) << w> table;
+    table[0] = context.one();
+    table[1] = context.to_montgomery(base);
+    for (size_t i = 2; i < table.size(); ++i) {
+        table[i] = i % 2 == 0 ? context.mont_sqr(table[i / 2]) : context.mont_mul(table[i - 1], table[1]);
+    }
+
+    const auto select = [&table](size_t index) {
+        number_t entry{0};
+        for (size_t i = 0; i < table.size(); ++i) {
+            // all ones for i == index, computed without a comparison
+            const value_t mask = value_t(0) - (value_t((i ^ index) - 1) >> (number_t::bits_in_word - 1));
+            for (size_t j = 0; j < number_t::word_count; ++j) {
+                entry[j] |= table[i][j] & mask;
+            }
+        }
+        return entry;
+    };
+
+    auto result = select(modexp::window_at(exponent, (windows - 1) * w, w));
+    for (size_t window = windows - 1; window-- > 0;) {
+        for (size_t i = 0; i < w; ++i) {
+            result = context.mont_sqr(result);
+        }
+        result = context.mont_mul(result, select(modexp::window_at(exponent, window * w, w)));
+    }
+    return context.from_montgomery(result);
+}
+
+// base^exponent mod n for an odd n, base of any size
+template <size_t BITS, size_t EXPONENT_BITS>
+constexpr uint_t<BITS> pow_mod(const uint_t<BITS> &base, const uint_t<EXPONENT_BITS> &exponent,
+                               const uint_t<BITS> &n) {
+    return pow_mod(Montgomery<BITS>{n}, base % n, exponent);
+}
+
+// base^exponent mod n for exponents that are not secret, like e = 65537 in RSA verification or the
+// exponents of primality tests. Sliding windows start at set bits only and use odd powers, runs of zero
+// bits cost one squaring per bit, and the window size follows the actual exponent length.
+template <size_t BITS, size_t EXPONENT_BITS>
+constexpr uint_t<BITS> pow_mod_public(const Montgomery<BITS> &context, const uint_t<BITS> &base,
+                                      const uint_t<EXPONENT_BITS> &exponent) {
+    using number_t = uint_t<BITS>;
+    constexpr auto max_w = modexp::window_bits(EXPONENT_BITS);
+    const auto length = modexp::bit_length(exponent);
+    if (length == 0) {
+        return context.from_montgomery(context.one());
+    }
+    const auto w = length <= 24 ? 1 : modexp::window_bits(length);
+
+    // table[i] = base^(2i + 1)
+    std::array<number_t, size_t(1) << (max_w - 1)> table;
+    table[0] = context.to_montgomery(base);
+    const auto base_squared = context.mont_sqr(table[0]);
+    for (size_t i = 1; i < (size_t(1) << (w - 1)); ++i) {
+        table[i] = context.mont_mul(table[i - 1], base_squared);
+    }
+
+    auto result = context.one();
+    bool started = false;
+    for (auto position = ptrdiff_t(length) - 1; position >= 0;) {
+        if (modexp::window_at(exponent, position, 1) == 0) {
+            result = context.mont_sqr(result);
+            --position;
+            continue;
+        }
+        // the longest window of at most w bits that ends in a set bit
+        auto low = std::max<ptrdiff_t>(position - ptrdiff_t(w) + 1, 0);
+        while (modexp::window_at(exponent, low, 1) == 0) {
+            ++low;
+        }
+        const auto bits = size_t(position - low + 1);
+        const auto value = modexp::window_at(exponent, low, bits);
+        if (started) {
+            for (size_t i = 0; i < bits; ++i) {
+                result = context.mont_sqr(result);
+            }
+            result = context.mont_mul(result, table[value / 2]);
+        } else {
+            result = table[value / 2];
+            started = true;
+        }
+        position = low - 1;
+    }
+    return context.from_montgomery(result);
+}
+
+template <size_t BITS, size_t EXPONENT_BITS>
+constexpr uint_t<BITS> pow_mod_public(const uint_t<BITS> &base, const uint_t<EXPONENT_BITS> &exponent,
+                                      const uint_t<BITS> &n) {
+    return pow_mod_public(Montgomery<BITS>{n}, base % n, exponent);
+}
+} // namespace understanding_crypto
+
+#endif
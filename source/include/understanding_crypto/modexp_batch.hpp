@@ -0,0 +1,316 @@
+#ifndef UNDERSTANDING_CRYPTO_MODEXP_BATCH_H
+#define UNDERSTANDING_CRYPTO_MODEXP_BATCH_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <understanding_crypto/biginteger.hpp>
+#include <understanding_crypto/cpu.hpp>
+#include <understanding_crypto/modexp.hpp>
+#include <understanding_crypto/montgomery.hpp>
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+#include <immintrin.h>
+#endif
+
+namespace understanding_crypto {
+namespace modexp {
+// Independent exponentiations side by side, one per SIMD lane. A number is stored in limbs of limb_bits
+// bits, limb i of all lanes in one vector, so the Montgomery multiplication of the lanes is the scalar
+// algorithm on vectors. Limbs are smaller than a word to leave room for the carries: the products of a
+// round are accumulated without carry propagation and the result is normalized once at the end. The
+// modulus, its inverse and the exponent can be different in every lane, only the sizes are shared.
+#ifdef UNDERSTANDING_CRYPTO_X86
+// AVX-512 IFMA multiplies the low 52 bits of every 64 bit lane and adds the low or the high 52 bits of the
+// product to an accumulator, eight lanes per instruction
+struct IFMA512 {
+    static bool supported() {
+        const auto &features = cpu::features();
+        return features.avx512f && features.avx512ifma;
+    }
+
+    static constexpr size_t lanes = 8;
+    static constexpr size_t limb_bits = 52;
+
+    // out = a * b / 2^(limb_bits * LIMBS) mod n for a and b below n, k0 = -n^-1 mod 2^limb_bits. Coarsely
+    // integrated like Montgomery::mont_mul: one pass per word of b adds a * b[i] and m * n and drops the
+    // lowest limb. out may be a or b
+    template <size_t LIMBS>
+    [[gnu::target("avx512f,avx512ifma")]]
+    static void mont_mul(const uint64_t *a, const uint64_t *b, const uint64_t *n, const uint64_t *k0,
+                         uint64_t *out) {
+        const auto zero = _mm512_setzero_si512();
+        const auto n_prime = load(k0);
+        __m512i t[LIMBS];
+        std::fill_n(t, LIMBS, zero);
+        for (size_t i = 0; i < LIMBS; ++i) {
+            const auto word = load(b + i * lanes);
+            auto a_previous = load(a);
+            auto n_previous = load(n);
+            auto x = _mm512_madd52lo_epu64(t[0], a_previous, word);
+            const auto m = _mm512_madd52lo_epu64(zero, x, n_prime);
+            x = _mm512_madd52lo_epu64(x, m, n_previous);
+            // the low limb_bits of x are zero now
+            const auto carry = _mm512_srli_epi64(x, limb_bits);
+
+            for (size_t j = 1; j < LIMBS; ++j) {
+                const auto a_word = load(a + j * lanes);
+                const auto n_word = load(n + j * lanes);
+                x = _mm512_madd52lo_epu64(t[j], a_word, word);
+                x = _mm512_madd52lo_epu64(x, m, n_word);
+                x = _mm512_madd52hi_epu64(x, a_previous, word);
+                t[j - 1] = _mm512_madd52hi_epu64(x, m, n_previous);
+                a_previous = a_word;
+                n_previous = n_word;
+            }
+            const auto high = _mm512_madd52hi_epu64(zero, a_previous, word);
+            t[LIMBS - 1] = _mm512_madd52hi_epu64(high, m, n_previous);
+            t[0] = _mm512_add_epi64(t[0], carry);
+        }
+
+        // t < 2n, normalize the limbs and subtract n unless that borrows past the top
+        const auto mask = _mm512_set1_epi64((uint64_t(1) << limb_bits) - 1);
+        auto top = zero;
+        for (auto &limb : t) {
+            const auto x = _mm512_add_epi64(limb, top);
+            top = _mm512_srli_epi64(x, limb_bits);
+            limb = _mm512_and_si512(x, mask);
+        }
+        __m512i difference[LIMBS];
+        auto borrow = zero;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            const auto x = _mm512_sub_epi64(_mm512_sub_epi64(t[j], load(n + j * lanes)), borrow);
+            borrow = _mm512_srli_epi64(x, 63);
+            difference[j] = _mm512_and_si512(x, mask);
+        }
+        const auto keep = _mm512_cmpgt_epu64_mask(borrow, top);
+        for (size_t j = 0; j < LIMBS; ++j) {
+            _mm512_storeu_si512(out + j * lanes, _mm512_mask_blend_epi64(keep, difference[j], t[j]));
+        }
+    }
+
+    // out = table[index] in every lane, all entries are read
+    template <size_t LIMBS>
+    [[gnu::target("avx512f")]]
+    static void select(const uint64_t *table, size_t entries, const uint64_t *index, uint64_t *out) {
+        const auto wanted = load(index);
+        for (size_t j = 0; j < LIMBS; ++j) {
+            auto limb = _mm512_setzero_si512();
+            for (size_t entry = 0; entry < entries; ++entry) {
+                const auto hit = _mm512_cmpeq_epu64_mask(wanted, _mm512_set1_epi64(int64_t(entry)));
+                limb = _mm512_mask_mov_epi64(limb, hit, load(table + (entry * LIMBS + j) * lanes));
+            }
+            _mm512_storeu_si512(out + j * lanes, limb);
+        }
+    }
+
+    [[gnu::target("avx512f")]] static __m512i load(const uint64_t *words) {
+        return _mm512_loadu_si512(words);
+    }
+};
+
+// AVX2 has no 64 bit multiplication, VPMULUDQ multiplies the low 32 bits of every lane. With 26 bit limbs
+// the products have 52 bits and a lane holds the sum of the products of thousands of rounds
+struct AVX2 {
+    static bool supported() { return cpu::features().avx2; }
+
+    static constexpr size_t lanes = 4;
+    static constexpr size_t limb_bits = 26;
+
+    template <size_t LIMBS>
+    [[gnu::target("avx2")]]
+    static void mont_mul(const uint64_t *a, const uint64_t *b, const uint64_t *n, const uint64_t *k0,
+                         uint64_t *out) {
+        const auto zero = _mm256_setzero_si256();
+        const auto mask = _mm256_set1_epi64x((uint64_t(1) << limb_bits) - 1);
+        const auto n_prime = load(k0);
+        __m256i t[LIMBS];
+        std::fill_n(t, LIMBS, zero);
+        for (size_t i = 0; i < LIMBS; ++i) {
+            const auto word = load(b + i * lanes);
+            auto x = _mm256_add_epi64(t[0], _mm256_mul_epu32(load(a), word));
+            const auto m = _mm256_and_si256(_mm256_mul_epu32(x, n_prime), mask);
+            x = _mm256_add_epi64(x, _mm256_mul_epu32(m, load(n)));
+            const auto carry = _mm256_srli_epi64(x, limb_bits);
+
+            for (size_t j = 1; j < LIMBS; ++j) {
+                x = _mm256_add_epi64(t[j], _mm256_mul_epu32(load(a + j * lanes), word));
+                t[j - 1] = _mm256_add_epi64(x, _mm256_mul_epu32(m, load(n + j * lanes)));
+            }
+            t[LIMBS - 1] = zero;
+            t[0] = _mm256_add_epi64(t[0], carry);
+        }
+
+        auto top = zero;
+        for (auto &limb : t) {
+            const auto x = _mm256_add_epi64(limb, top);
+            top = _mm256_srli_epi64(x, limb_bits);
+            limb = _mm256_and_si256(x, mask);
+        }
+        __m256i difference[LIMBS];
+        auto borrow = zero;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            const auto x = _mm256_sub_epi64(_mm256_sub_epi64(t[j], load(n + j * lanes)), borrow);
+            borrow = _mm256_srli_epi64(x, 63);
+            difference[j] = _mm256_and_si256(x, mask);
+        }
+        // borrow and top are 0 or 1, the signed comparison is fine
+        const auto keep = _mm256_cmpgt_epi64(borrow, top);
+        for (size_t j = 0; j < LIMBS; ++j) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + j * lanes),
+                                _mm256_blendv_epi8(difference[j], t[j], keep));
+        }
+    }
+
+    template <size_t LIMBS>
+    [[gnu::target("avx2")]]
+    static void select(const uint64_t *table, size_t entries, const uint64_t *index, uint64_t *out) {
+        const auto wanted = load(index);
+        for (size_t j = 0; j < LIMBS; ++j) {
+            auto limb = _mm256_setzero_si256();
+            for (size_t entry = 0; entry < entries; ++entry) {
+                const auto hit = _mm256_cmpeq_epi64(wanted, _mm256_set1_epi64x(int64_t(entry)));
+                const auto candidate = load(table + (entry * LIMBS + j) * lanes);
+                limb = _mm256_or_si256(limb, _mm256_and_si256(hit, candidate));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + j * lanes), limb);
+        }
+    }
+
+    [[gnu::target("avx2")]] static __m256i load(const uint64_t *words) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words));
+    }
+};
+#endif
+
+// bases, exponents and results have to hold one entry per modulus
+template <size_t BITS, size_t EXPONENT_BITS>
+void check_batch_sizes(std::span<const uint_t<BITS>> bases, std::span<const uint_t<EXPONENT_BITS>> exponents,
+                       std::span<const uint_t<BITS>> moduli, std::span<uint_t<BITS>> results) {
+    if (bases.size() < moduli.size() || exponents.size() < moduli.size() || results.size() < moduli.size()) {
+        throw std::invalid_argument("fewer bases, exponents or results than moduli");
+    }
+}
+
+// pow_mod for every group of engine::lanes jobs, the fixed window method with the window table select
+// and the squarings done for all lanes at once. Returns the number of jobs done, the rest does not fill
+// a group. Every modulus must be odd
+template <typename engine, size_t BITS, size_t EXPONENT_BITS>
+size_t pow_mod_lanes(std::span<const uint_t<BITS>> bases, std::span<const uint_t<EXPONENT_BITS>> exponents,
+                     std::span<const uint_t<BITS>> moduli, std::span<uint_t<BITS>> results) {
+    check_batch_sizes(bases, exponents, moduli, results);
+    constexpr auto lanes = engine::lanes;
+    constexpr auto limb_bits = engine::limb_bits;
+    constexpr auto limbs = (BITS + limb_bits - 1) / limb_bits;
+    constexpr auto w = window_bits(EXPONENT_BITS);
+    constexpr auto windows = (EXPONENT_BITS + w - 1) / w;
+    constexpr auto entries = size_t(1) << w;
+    // words of one number in all lanes
+    constexpr auto size = limbs * lanes;
+    constexpr auto limb_mask = (uint64_t(1) << limb_bits) - 1;
+    constexpr auto bits_in_word = uint_t<BITS>::bits_in_word;
+
+    // table, n, r2, one, base and the accumulator
+    std::vector<uint64_t> storage((entries + 5) * size);
+    const auto table = storage.data();
+    const auto n = table + entries * size, r2 = n + size, unit = r2 + size, base = unit + size;
+    const auto accumulator = base + size;
+    std::array<uint64_t, lanes> k0, index;
+
+    const auto to_limbs = [](const uint_t<BITS> &x, uint64_t *number, size_t lane) {
+        for (size_t i = 0; i < limbs; ++i) {
+            number[i * lanes + lane] = window_at(x, i * limb_bits, limb_bits);
+        }
+    };
+
+    const auto jobs = moduli.size() - moduli.size() % lanes;
+    for (size_t offset = 0; offset < jobs; offset += lanes) {
+        std::fill(unit, unit + size, 0);
+        std::fill(unit, unit + lanes, 1);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const auto &modulus = moduli[offset + lane];
+            k0[lane] = (0 - word_inverse(uint64_t(modulus[0]))) & limb_mask;
+
+            // R^2 mod n for the R = 2^(limb_bits * limbs) of the limbs
+            constexpr auto exponent_of_r2 = 2 * limb_bits * limbs;
+            uint_t<exponent_of_r2 + 1> power{0};
+            power[exponent_of_r2 / bits_in_word] = uint64_t(1) << (exponent_of_r2 % bits_in_word);
+            to_limbs(modulus, n, lane);
+            to_limbs(power % modulus, r2, lane);
+            to_limbs(bases[offset + lane] % modulus, base, lane);
+        }
+
+        const auto entry = [table](size_t i) { return table + i * size; };
+        engine::template mont_mul<limbs>(r2, unit, n, k0.data(), entry(0));
+        engine::template mont_mul<limbs>(base, r2, n, k0.data(), entry(1));
+        for (size_t i = 2; i < entries; ++i) {
+            if (i % 2 == 0) {
+                engine::template mont_mul<limbs>(entry(i / 2), entry(i / 2), n, k0.data(), entry(i));
+            } else {
+                engine::template mont_mul<limbs>(entry(i - 1), entry(1), n, k0.data(), entry(i));
+            }
+        }
+
+        const auto select = [&](size_t window, uint64_t *out) {
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                index[lane] = window_at(exponents[offset + lane], window * w, w);
+            }
+            engine::template select<limbs>(table, entries, index.data(), out);
+        };
+        select(windows - 1, accumulator);
+        for (size_t window = windows - 1; window-- > 0;) {
+            for (size_t i = 0; i < w; ++i) {
+                engine::template mont_mul<limbs>(accumulator, accumulator, n, k0.data(), accumulator);
+            }
+            select(window, base);
+            engine::template mont_mul<limbs>(accumulator, base, n, k0.data(), accumulator);
+        }
+        engine::template mont_mul<limbs>(accumulator, unit, n, k0.data(), accumulator);
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            auto &result = results[offset + lane];
+            result = uint_t<BITS>{0};
+            for (size_t i = 0; i < limbs; ++i) {
+                const auto limb = accumulator[i * lanes + lane];
+                const auto bit = i * limb_bits;
+                const auto word = bit / bits_in_word, shift = bit % bits_in_word;
+                result[word] |= limb << shift;
+                if (shift + limb_bits > bits_in_word && word + 1 < result.word_count) {
+                    result[word + 1] |= limb >> (bits_in_word - shift);
+                }
+            }
+        }
+    }
+    return jobs;
+}
+} // namespace modexp
+
+// results[i] = bases[i]^exponents[i] mod moduli[i] for odd moduli, the exponents secret. Groups of 8 jobs
+// run in the lanes of AVX-512 IFMA, else groups of 4 with AVX2, what is left over and everything on other
+// processors goes through pow_mod one at a time. The results are the same either way. Spans shorter than
+// moduli throw std::invalid_argument
+template <size_t BITS, size_t EXPONENT_BITS>
+void pow_mod_batch(std::span<const uint_t<BITS>> bases, std::span<const uint_t<EXPONENT_BITS>> exponents,
+                   std::span<const uint_t<BITS>> moduli, std::span<uint_t<BITS>> results) {
+    modexp::check_batch_sizes(bases, exponents, moduli, results);
+    size_t done = 0;
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (modexp::IFMA512::supported()) {
+        done = modexp::pow_mod_lanes<modexp::IFMA512>(bases, exponents, moduli, results);
+    } else if (modexp::AVX2::supported()) {
+        done = modexp::pow_mod_lanes<modexp::AVX2>(bases, exponents, moduli, results);
+    }
+#endif
+    for (size_t i = done; i < moduli.size(); ++i) {
+        results[i] = pow_mod(bases[i], exponents[i], moduli[i]);
+    }
+}
+} // namespace understanding_crypto
+
+#endif
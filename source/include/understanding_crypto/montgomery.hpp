@@ -0,0 +1,142 @@
+#ifndef UNDERSTANDING_CRYPTO_MONTGOMERY_H
+#define UNDERSTANDING_CRYPTO_MONTGOMERY_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <understanding_crypto/biginteger.hpp>
+
+namespace understanding_crypto {
+// x^-1 modulo 2^(8 * sizeof(value_t)) for odd x. Newton iteration, every step doubles the number of correct
+// low bits; x * x = 1 mod 8
+template <typename value_t> constexpr value_t word_inverse(value_t x) {
+    value_t inverse = x;
+    for (auto i = 0U; i < 6; ++i) {
+        inverse *= 2 - x * inverse;
+    }
+    return inverse;
+}
+
+// Montgomery arithmetic modulo an odd n below 2^BITS, with R = 2^(bits_in_word * word_count). Values in
+// Montgomery form are a * R mod n and stay below n. Every operation runs the same instructions for all
+// operand values: fixed loop counts and a masked final subtraction. Nothing allocates.
+template <std::size_t BITS> class Montgomery {
+  public:
+    using number_t = uint_t<BITS>;
+    using value_t = typename number_t::value_t;
+    using double_value_t = typename number_t::double_value_t;
+    static constexpr auto word_count = number_t::word_count;
+    static constexpr auto bits_in_word = number_t::bits_in_word;
+
+    constexpr explicit Montgomery(const number_t &modulus) : n(modulus) {
+        n_prime = 0 - word_inverse(n[0]);
+
+        // R^2 mod n by doubling 1 modulo n, 2 * bits_in_word * word_count times
+        number_t x{1};
+        for (auto i = 0U; i < 2 * bits_in_word * word_count; ++i) {
+            x = double_modulo(x);
+        }
+        r2 = x;
+    }
+
+    constexpr const number_t &modulus() const { return n; }
+
+    constexpr number_t to_montgomery(const number_t &a) const { return mont_mul(a, r2); }
+    constexpr number_t from_montgomery(const number_t &a) const { return mont_mul(a, number_t{1}); }
+    // R mod n, one in Montgomery form
+    constexpr number_t one() const { return from_montgomery(r2); }
+
+    // a * b / R mod n, coarsely integrated operand scanning with both inner loops fused: the product
+    // row and the reduction row go through t in one pass
+    constexpr number_t mont_mul(const number_t &a, const number_t &b) const {
+        std::array<value_t, word_count + 1> t{};
+        for (size_t i = 0; i < word_count; ++i) {
+            auto product = double_value_t(a[0]) * b[i] + t[0];
+            const value_t m = value_t(product) * n_prime;
+            auto reduction = double_value_t(m) * n[0] + value_t(product);
+            product >>= bits_in_word;
+            reduction >>= bits_in_word;
+
+            for (size_t j = 1; j < word_count; ++j) {
+                product += double_value_t(a[j]) * b[i] + t[j];
+                reduction += double_value_t(m) * n[j] + value_t(product);
+                t[j - 1] = value_t(reduction);
+                product >>= bits_in_word;
+                reduction >>= bits_in_word;
+            }
+            const auto top = double_value_t(t[word_count]) + value_t(product) + value_t(reduction);
+            t[word_count - 1] = value_t(top);
+            t[word_count] = value_t(top >> bits_in_word);
+        }
+        return subtract_modulus(t);
+    }
+
+    // a * a / R mod n. The square comes from the squaring kernel of uint_t, which computes every cross
+    // product once; the reduction follows separately
+    constexpr number_t mont_sqr(const number_t &a) const {
+        std::array<value_t, 2 * word_count + 1> t;
+        number_t::template multiply_full<word_count, true>(a.internal_main.data(), a.internal_main.data(),
+                                                           t.data());
+
+        // one word of t per round, t + m * n is divisible by the word base. The carry out of the top word
+        // of a round is added in the next round instead of running through the rest of t
+        value_t top_carry = 0;
+        for (size_t i = 0; i < word_count; ++i) {
+            const value_t m = t[i] * n_prime;
+            double_value_t reduction = 0;
+            for (size_t j = 0; j < word_count; ++j) {
+                reduction += double_value_t(m) * n[j] + t[i + j];
+                t[i + j] = value_t(reduction);
+                reduction >>= bits_in_word;
+            }
+            reduction += double_value_t(t[i + word_count]) + top_carry;
+            t[i + word_count] = value_t(reduction);
+            top_carry = value_t(reduction >> bits_in_word);
+        }
+        t[2 * word_count] = top_carry;
+
+        std::array<value_t, word_count + 1> high;
+        for (size_t i = 0; i < high.size(); ++i) {
+            high[i] = t[word_count + i];
+        }
+        return subtract_modulus(high);
+    }
+
+  private:
+    // t < 2n, returns t - n if that does not borrow, t otherwise. Both are computed, a mask selects
+    constexpr number_t subtract_modulus(const std::array<value_t, word_count + 1> &t) const {
+        number_t difference;
+        value_t borrow = 0;
+        for (size_t i = 0; i < word_count; ++i) {
+            const auto word = double_value_t(t[i]) - n[i] - borrow;
+            difference[i] = value_t(word);
+            borrow = value_t(word >> bits_in_word) & 1;
+        }
+        // keep t when the subtraction borrowed past the top word
+        const value_t keep = 0 - value_t(borrow > t[word_count]);
+        number_t result;
+        for (size_t i = 0; i < word_count; ++i) {
+            result[i] = (t[i] & keep) | (difference[i] & ~keep);
+        }
+        return result;
+    }
+
+    // 2x mod n for x < n
+    constexpr number_t double_modulo(const number_t &x) const {
+        std::array<value_t, word_count + 1> doubled{};
+        for (size_t i = 0; i < word_count; ++i) {
+            doubled[i] |= x[i] << 1;
+            doubled[i + 1] = x[i] >> (bits_in_word - 1);
+        }
+        return subtract_modulus(doubled);
+    }
+
+    number_t n;
+    number_t r2;
+    value_t n_prime;
+};
+} // namespace understanding_crypto
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef UNDERSTANDING_CRYPTO_PARALLEL_H
+#define UNDERSTANDING_CRYPTO_PARALLEL_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <understanding_crypto/aes.hpp>
+#include <understanding_crypto/cbc.hpp>
+#include <understanding_crypto/ctr.hpp>
+#include <understanding_crypto/gcm.hpp>
+#include <understanding_crypto/thread_pool.hpp>
+
+namespace understanding_crypto::aes {
+// the modes whose blocks are independent, split into chunks that run on a thread pool. Every mode writes
+// exactly the bytes of its single threaded counterpart. Output may be the same memory as input.
+class Parallel {
+  public:
+    static constexpr size_t block_size = 16;
+    // fits the second level cache of one core together with its output
+    static constexpr size_t default_chunk_size = 256 * 1024;
+
+    // the chunk size is rounded down to whole blocks
+    explicit Parallel(size_t threads = Thread_Pool::default_threads(), size_t chunk_size = default_chunk_size)
+        : pool(threads), chunk_size(std::max(block_size, chunk_size / block_size * block_size)) {}
+
+    size_t threads() const { return pool.size(); }
+
+    // bytes holds whole blocks
+    template <typename expanded_keys_t>
+    void ecb_encrypt(std::span<uint8_t> bytes, const expanded_keys_t &keys) {
+        for_each_chunk(bytes.size(), [&](size_t offset, size_t length) {
+            AES::encrypt_blocks(bytes.subspan(offset, length), keys);
+        });
+    }
+
+    template <typename expanded_keys_t>
+    void ecb_decrypt(std::span<uint8_t> bytes, const expanded_keys_t &keys) {
+        for_each_chunk(bytes.size(), [&](size_t offset, size_t length) {
+            AES::decrypt_blocks(bytes.subspan(offset, length), keys);
+        });
+    }
+
+    // the same as CTR::process on a fresh CTR, each chunk seeks to its own offset
+    template <typename expanded_keys_t>
+    void ctr(const expanded_keys_t &keys, std::span<const uint8_t, block_size> counter_block,
+             std::span<const uint8_t> input, std::span<uint8_t> output) {
+        for_each_chunk(input.size(), [&](size_t offset, size_t length) {
+            CTR ctr{keys, counter_block};
+            ctr.seek(offset);
+            ctr.process(input.subspan(offset, length), output.subspan(offset, length));
+        });
+    }
+
+    // input holds whole blocks, checked here rather than in the workers. The ciphertext block in front of
+    // every chunk is saved before any chunk starts, it is the IV of that chunk
+    template <typename expanded_keys_t>
+    void cbc_decrypt(const expanded_keys_t &keys, std::span<const uint8_t, block_size> iv,
+                     std::span<const uint8_t> input, std::span<uint8_t> output) {
+        if (input.size() % block_size != 0) {
+            throw std::invalid_argument("CBC input is not a multiple of the block size");
+        }
+        using block_t = std::array<uint8_t, block_size>;
+        std::vector<block_t> previous(chunk_count(input.size()));
+        for (auto i = 0U; i < previous.size(); ++i) {
+            const auto source = i == 0 ? iv.data() : &input[i * chunk_size - block_size];
+            std::copy_n(source, block_size, previous[i].begin());
+        }
+
+        for_each_chunk(input.size(), [&](size_t offset, size_t length) {
+            CBC cbc{keys, std::span<const uint8_t, block_size>(previous[offset / chunk_size])};
+            cbc.decrypt(input.subspan(offset, length), output.subspan(offset, length));
+        });
+    }
+
+    // counter mode and GHASH run per chunk, the partial hashes are folded together with
+    // Y = Y * H^n + Y_chunk afterwards
+    template <typename expanded_keys_t>
+    void gcm_encrypt(const GCM<expanded_keys_t> &gcm, std::span<const uint8_t> iv,
+                     std::span<const uint8_t> aad, std::span<const uint8_t> plain, std::span<uint8_t> cipher,
+                     std::span<uint8_t, GCM<expanded_keys_t>::tag_size> tag) {
+        const auto j0 = gcm.initial_counter(iv);
+        auto y = gcm_hash<true>(gcm, j0, aad, plain, cipher);
+        gcm.finish(j0, y, aad.size(), plain.size(), tag);
+    }
+
+    // returns false and clears plain if the tag does not match
+    template <typename expanded_keys_t>
+    bool gcm_decrypt(const GCM<expanded_keys_t> &gcm, std::span<const uint8_t> iv,
+                     std::span<const uint8_t> aad, std::span<const uint8_t> cipher, std::span<uint8_t> plain,
+                     std::span<const uint8_t, GCM<expanded_keys_t>::tag_size> tag) {
+        const auto j0 = gcm.initial_counter(iv);
+        auto y = gcm_hash<false>(gcm, j0, aad, cipher, plain);
+
+        std::array<uint8_t, GCM<expanded_keys_t>::tag_size> expected;
+        gcm.finish(j0, y, aad.size(), cipher.size(), expected);
+        if (!GCM<expanded_keys_t>::tags_equal(expected, tag)) {
+            std::fill_n(plain.begin(), cipher.size(), 0);
+            return false;
+        }
+        return true;
+    }
+
+  private:
+    size_t chunk_count(size_t size) const { return (size + chunk_size - 1) / chunk_size; }
+
+    template <typename function_t> void for_each_chunk(size_t size, const function_t &function) {
+        pool.for_each(chunk_count(size), [&](size_t i) {
+            const auto offset = i * chunk_size;
+            function(offset, std::min(chunk_size, size - offset));
+        });
+    }
+
+    template <bool encrypting, typename expanded_keys_t>
+    GHASH::element_t gcm_hash(const GCM<expanded_keys_t> &gcm, const GCM<expanded_keys_t>::block_t &j0,
+                              std::span<const uint8_t> aad, std::span<const uint8_t> input,
+                              std::span<uint8_t> output) {
+        std::vector<GHASH::element_t> partial(chunk_count(input.size()));
+        for_each_chunk(input.size(), [&](size_t offset, size_t length) {
+            gcm.template process_segment<encrypting>(j0, offset / block_size, input.subspan(offset, length),
+                                                     output.subspan(offset, length),
+                                                     partial[offset / chunk_size]);
+        });
+
+        GHASH::element_t y{};
+        gcm.hash().absorb(y, aad);
+        const auto &ghash = gcm.hash();
+        const auto chunk_power = ghash.power_of_h(chunk_size / block_size);
+        for (auto i = 0U; i < partial.size(); ++i) {
+            const auto length = std::min(chunk_size, input.size() - i * chunk_size);
+            const auto blocks = (length + block_size - 1) / block_size;
+            const auto power = length == chunk_size ? chunk_power : ghash.power_of_h(blocks);
+            y = GHASH::multiply(y, power);
+            y ^= partial[i];
+        }
+        return y;
+    }
+
+    Thread_Pool pool;
+    size_t chunk_size;
+};
+} // namespace understanding_crypto::aes
+
+#endif
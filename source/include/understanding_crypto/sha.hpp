@@ -0,0 +1,551 @@
+#ifndef UNDERSTANDING_CRYPTO_SHA_H
+#define UNDERSTANDING_CRYPTO_SHA_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <understanding_crypto/cpu.hpp>
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+#include <immintrin.h>
+#endif
+
+namespace understanding_crypto::sha {
+// the eight working variables a to h (FIPS 180-4 6.2)
+using state_t = std::array<uint32_t, 8>;
+constexpr size_t block_size = 64;
+
+// FIPS 180-4 4.2.2
+constexpr std::array<uint32_t, 64> round_constants = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+constexpr uint32_t load_big_endian(const uint8_t *bytes) {
+    return uint32_t(bytes[0]) << 24 | uint32_t(bytes[1]) << 16 | uint32_t(bytes[2]) << 8 | bytes[3];
+}
+
+constexpr void store_big_endian(uint32_t word, uint8_t *bytes) {
+    for (auto i = 0U; i < 4; ++i) {
+        bytes[i] = uint8_t(word >> (24 - 8 * i));
+    }
+}
+
+// the compression function of FIPS 180-4 6.2.2 on 32 bit words, for any processor
+struct Reference {
+    // blocks holds whole blocks
+    static void compress(state_t &state, std::span<const uint8_t> blocks) {
+        for (size_t offset = 0; offset < blocks.size(); offset += block_size) {
+            std::array<uint32_t, 64> w;
+            for (auto t = 0U; t < 16; ++t) {
+                w[t] = load_big_endian(&blocks[offset + 4 * t]);
+            }
+            for (auto t = 16U; t < 64; ++t) {
+                const auto s0 = std::rotr(w[t - 15], 7) ^ std::rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+                const auto s1 = std::rotr(w[t - 2], 17) ^ std::rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+                w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+            }
+
+            auto [a, b, c, d, e, f, g, h] = state;
+            for (auto t = 0U; t < 64; ++t) {
+                const auto t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) +
+                                ((e & f) ^ (~e & g)) + round_constants[t] + w[t];
+                const auto t2 =
+                    (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            const state_t result = {a, b, c, d, e, f, g, h};
+            for (auto i = 0U; i < 8; ++i) {
+                state[i] += result[i];
+            }
+        }
+    }
+};
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+// SHA256RNDS2 runs two rounds on the state split into the registers ABEF and CDGH, SHA256MSG1 and
+// SHA256MSG2 compute the message schedule four words at a time
+struct SHANI {
+    static bool supported() {
+        const auto &features = cpu::features();
+        return features.sha && features.ssse3 && features.sse41;
+    }
+
+    [[gnu::target("sha,ssse3,sse4.1")]]
+    static void compress(state_t &state, std::span<const uint8_t> blocks) {
+        const auto swap_bytes = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        // DCBA and HGFE in memory order to ABEF and CDGH
+        const auto *words = reinterpret_cast<const __m128i *>(state.data());
+        const auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(words), 0xb1);
+        const auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(words + 1), 0x1b);
+        auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+        auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+        for (size_t offset = 0; offset < blocks.size(); offset += block_size) {
+            const auto abef_before = abef, cdgh_before = cdgh;
+            // w[i % 4] holds the schedule words 4i to 4i + 3
+            __m128i w[4];
+            for (auto i = 0U; i < 4; ++i) {
+                const auto *bytes = reinterpret_cast<const __m128i *>(&blocks[offset + 16 * i]);
+                w[i] = _mm_shuffle_epi8(_mm_loadu_si128(bytes), swap_bytes);
+            }
+#pragma GCC unroll 16
+            for (auto i = 0U; i < 16; ++i) {
+                if (i >= 4) {
+                    // w[t - 16] + s0(w[t - 15]) + w[t - 7], then s1(w[t - 2])
+                    auto next = _mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]);
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+                    w[i % 4] = _mm_sha256msg2_epu32(next, w[(i + 3) % 4]);
+                }
+                auto message = _mm_add_epi32(
+                    w[i % 4], _mm_loadu_si128(reinterpret_cast<const __m128i *>(&round_constants[4 * i])));
+                cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+                message = _mm_shuffle_epi32(message, 0x0e);
+                abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+            }
+            abef = _mm_add_epi32(abef, abef_before);
+            cdgh = _mm_add_epi32(cdgh, cdgh_before);
+        }
+
+        const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+        const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+    }
+};
+#endif
+
+enum class Engine { SOFTWARE, SHANI };
+
+// chosen on first use
+inline Engine engine() {
+    static const auto engine = [] {
+#ifdef UNDERSTANDING_CRYPTO_X86
+        if (SHANI::supported())
+            return Engine::SHANI;
+#endif
+        return Engine::SOFTWARE;
+    }();
+    return engine;
+}
+
+inline void compress(state_t &state, std::span<const uint8_t> blocks) {
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (engine() == Engine::SHANI) {
+        SHANI::compress(state, blocks);
+        return;
+    }
+#endif
+    Reference::compress(state, blocks);
+}
+
+// SHA-256 and SHA-224 (FIPS 180-4 6.2, 6.3), which differ in the initial state and the digest length.
+// update passes whole blocks of the input to the compression function where they are, only a partial
+// block is copied into the buffer. finalize pads, returns the digest and starts a new message
+template <size_t DIGEST_SIZE> class SHA2_256 {
+    static_assert(DIGEST_SIZE == 28 || DIGEST_SIZE == 32, "SHA-224 or SHA-256");
+
+  public:
+    static constexpr size_t digest_size = DIGEST_SIZE;
+    using digest_t = std::array<uint8_t, digest_size>;
+
+    // FIPS 180-4 5.3.2 and 5.3.3
+    static constexpr state_t initial_state =
+        digest_size == 32 ? state_t{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                    0x1f83d9ab, 0x5be0cd19}
+                          : state_t{0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511,
+                                    0x64f98fa7, 0xbefa4fa4};
+
+    void update(std::span<const uint8_t> data) {
+        length += data.size();
+        if (buffered > 0) {
+            const auto taken = std::min(data.size(), block_size - buffered);
+            std::copy_n(data.begin(), taken, buffer.begin() + buffered);
+            buffered += taken;
+            data = data.subspan(taken);
+            if (buffered < block_size) {
+                return;
+            }
+            compress(state, buffer);
+            buffered = 0;
+        }
+        const auto whole = data.size() - data.size() % block_size;
+        if (whole > 0) {
+            compress(state, data.first(whole));
+        }
+        std::copy(data.begin() + whole, data.end(), buffer.begin());
+        buffered = data.size() - whole;
+    }
+
+    digest_t finalize() {
+        // 0x80, zeros up to 56 bytes into a block, the message length in bits
+        const auto bits = uint64_t(length) * 8;
+        std::fill(buffer.begin() + buffered, buffer.end(), 0);
+        buffer[buffered] = 0x80;
+        if (buffered >= block_size - 8) {
+            compress(state, buffer);
+            buffer.fill(0);
+        }
+        store_big_endian(uint32_t(bits >> 32), &buffer[block_size - 8]);
+        store_big_endian(uint32_t(bits), &buffer[block_size - 4]);
+        compress(state, buffer);
+
+        digest_t digest;
+        for (size_t i = 0; i < digest_size / 4; ++i) {
+            store_big_endian(state[i], &digest[4 * i]);
+        }
+        *this = SHA2_256{};
+        return digest;
+    }
+
+    static digest_t hash(std::span<const uint8_t> data) {
+        SHA2_256 hasher;
+        hasher.update(data);
+        return hasher.finalize();
+    }
+
+  private:
+    state_t state = initial_state;
+    std::array<uint8_t, block_size> buffer;
+    size_t buffered = 0;
+    size_t length = 0;
+};
+
+using SHA256 = SHA2_256<32>;
+using SHA224 = SHA2_256<28>;
+
+// Multi-buffer hashing runs the compression function of independent messages side by side, one message
+// per 32 bit lane with state word i of all lanes in one vector. compress takes count consecutive blocks
+// from every blocks[lane], states holds the eight words of all lanes, word i at states + i * lanes
+#ifdef UNDERSTANDING_CRYPTO_X86
+struct AVX2 {
+    static bool supported() { return cpu::features().avx2; }
+
+    static constexpr size_t lanes = 8;
+
+    [[gnu::target("avx2")]]
+    static void compress(uint32_t *states, const uint8_t *const *blocks, size_t count) {
+        __m256i state[8];
+        for (auto i = 0U; i < 8; ++i) {
+            state[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states + i * lanes));
+        }
+        for (size_t block = 0; block < count; ++block) {
+            __m256i w[16];
+            load_words(blocks, block * block_size, &w[0]);
+            load_words(blocks, block * block_size + 32, &w[8]);
+
+            auto [a, b, c, d, e, f, g, h] = state;
+#pragma GCC unroll 64
+            for (auto t = 0U; t < 64; ++t) {
+                if (t >= 16) {
+                    const auto w15 = w[(t + 1) % 16], w2 = w[(t + 14) % 16];
+                    const auto s0 = xor3(rotr<7>(w15), rotr<18>(w15), _mm256_srli_epi32(w15, 3));
+                    const auto s1 = xor3(rotr<17>(w2), rotr<19>(w2), _mm256_srli_epi32(w2, 10));
+                    w[t % 16] = add(add(w[t % 16], s0), add(w[(t + 9) % 16], s1));
+                }
+                const auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                const auto t1 = add(add(add(h, xor3(rotr<6>(e), rotr<11>(e), rotr<25>(e))), ch),
+                                    add(_mm256_set1_epi32(int(round_constants[t])), w[t % 16]));
+                // (a & b) | (c & (a | b)) as (a & b) ^ (c & (a ^ b))
+                const auto maj =
+                    _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+                const auto t2 = add(xor3(rotr<2>(a), rotr<13>(a), rotr<22>(a)), maj);
+                h = g;
+                g = f;
+                f = e;
+                e = add(d, t1);
+                d = c;
+                c = b;
+                b = a;
+                a = add(t1, t2);
+            }
+            const __m256i result[8] = {a, b, c, d, e, f, g, h};
+            for (auto i = 0U; i < 8; ++i) {
+                state[i] = add(state[i], result[i]);
+            }
+        }
+        for (auto i = 0U; i < 8; ++i) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(states + i * lanes), state[i]);
+        }
+    }
+
+  private:
+    // words 8j to 8j + 7 of the block at offset in every lane, transposed so that out[i] holds one word of
+    // all lanes
+    [[gnu::target("avx2")]]
+    static void load_words(const uint8_t *const *blocks, size_t offset, __m256i *out) {
+        __m256i rows[lanes], pairs[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            rows[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[lane] + offset));
+        }
+        // words 0, 1, 4, 5 and 2, 3, 6, 7 of two rows interleaved, then of four rows
+        for (auto i = 0U; i < lanes; i += 2) {
+            pairs[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+            pairs[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+        }
+        for (auto i = 0U; i < lanes; i += 4) {
+            rows[i] = _mm256_unpacklo_epi64(pairs[i], pairs[i + 2]);
+            rows[i + 1] = _mm256_unpackhi_epi64(pairs[i], pairs[i + 2]);
+            rows[i + 2] = _mm256_unpacklo_epi64(pairs[i + 1], pairs[i + 3]);
+            rows[i + 3] = _mm256_unpackhi_epi64(pairs[i + 1], pairs[i + 3]);
+        }
+        // rows[j] holds words j and j + 4 of lanes 0 to 3, rows[4 + j] those of lanes 4 to 7
+        const auto swap_bytes = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                  0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        for (auto j = 0U; j < 4; ++j) {
+            out[j] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(rows[j], rows[4 + j], 0x20), swap_bytes);
+            out[4 + j] =
+                _mm256_shuffle_epi8(_mm256_permute2x128_si256(rows[j], rows[4 + j], 0x31), swap_bytes);
+        }
+    }
+
+    template <int BITS> [[gnu::target("avx2")]] static __m256i rotr(__m256i x) {
+        return _mm256_or_si256(_mm256_srli_epi32(x, BITS), _mm256_slli_epi32(x, 32 - BITS));
+    }
+    [[gnu::target("avx2")]] static __m256i xor3(__m256i x, __m256i y, __m256i z) {
+        return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+    }
+    [[gnu::target("avx2")]] static __m256i add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+};
+
+// sixteen lanes, with the rotations and the three input boolean functions in one instruction each
+struct AVX512 {
+    static bool supported() {
+        const auto &features = cpu::features();
+        return features.avx512f && features.avx512bw;
+    }
+
+    static constexpr size_t lanes = 16;
+
+    [[gnu::target("avx512f,avx512bw")]]
+    static void compress(uint32_t *states, const uint8_t *const *blocks, size_t count) {
+        __m512i state[8];
+        for (auto i = 0U; i < 8; ++i) {
+            state[i] = _mm512_loadu_si512(states + i * lanes);
+        }
+        for (size_t block = 0; block < count; ++block) {
+            __m512i w[16];
+            load_words(blocks, block * block_size, w);
+
+            auto [a, b, c, d, e, f, g, h] = state;
+#pragma GCC unroll 64
+            for (auto t = 0U; t < 64; ++t) {
+                if (t >= 16) {
+                    const auto w15 = w[(t + 1) % 16], w2 = w[(t + 14) % 16];
+                    const auto s0 = xor3(_mm512_ror_epi32(w15, 7), _mm512_ror_epi32(w15, 18),
+                                         _mm512_srli_epi32(w15, 3));
+                    const auto s1 = xor3(_mm512_ror_epi32(w2, 17), _mm512_ror_epi32(w2, 19),
+                                         _mm512_srli_epi32(w2, 10));
+                    w[t % 16] = add(add(w[t % 16], s0), add(w[(t + 9) % 16], s1));
+                }
+                // 0xca is e ? f : g, 0xe8 the majority
+                const auto ch = _mm512_ternarylogic_epi32(e, f, g, 0xca);
+                const auto sigma1 =
+                    xor3(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25));
+                const auto t1 = add(add(add(h, sigma1), ch),
+                                    add(_mm512_set1_epi32(int(round_constants[t])), w[t % 16]));
+                const auto sigma0 =
+                    xor3(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22));
+                const auto t2 = add(sigma0, _mm512_ternarylogic_epi32(a, b, c, 0xe8));
+                h = g;
+                g = f;
+                f = e;
+                e = add(d, t1);
+                d = c;
+                c = b;
+                b = a;
+                a = add(t1, t2);
+            }
+            const __m512i result[8] = {a, b, c, d, e, f, g, h};
+            for (auto i = 0U; i < 8; ++i) {
+                state[i] = add(state[i], result[i]);
+            }
+        }
+        for (auto i = 0U; i < 8; ++i) {
+            _mm512_storeu_si512(states + i * lanes, state[i]);
+        }
+    }
+
+  private:
+    // the 16 words of the block at offset in every lane, transposed so that out[i] holds word i of all lanes
+    [[gnu::target("avx512f,avx512bw")]]
+    static void load_words(const uint8_t *const *blocks, size_t offset, __m512i *out) {
+        __m512i rows[lanes], pairs[lanes];
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            rows[lane] = _mm512_loadu_si512(blocks[lane] + offset);
+        }
+        // in every 128 bit part, words 4k to 4k + 3 of two rows interleaved, then of four rows
+        for (auto i = 0U; i < lanes; i += 2) {
+            pairs[i] = _mm512_unpacklo_epi32(rows[i], rows[i + 1]);
+            pairs[i + 1] = _mm512_unpackhi_epi32(rows[i], rows[i + 1]);
+        }
+        for (auto i = 0U; i < lanes; i += 4) {
+            rows[i] = _mm512_unpacklo_epi64(pairs[i], pairs[i + 2]);
+            rows[i + 1] = _mm512_unpackhi_epi64(pairs[i], pairs[i + 2]);
+            rows[i + 2] = _mm512_unpacklo_epi64(pairs[i + 1], pairs[i + 3]);
+            rows[i + 3] = _mm512_unpackhi_epi64(pairs[i + 1], pairs[i + 3]);
+        }
+        // part k of rows[4g + j] holds word 4k + j of lanes 4g to 4g + 3, transpose the 4x4 parts
+        const auto swap_bytes = _mm512_set_epi64(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        for (auto j = 0U; j < 4; ++j) {
+            const auto low_parts = _mm512_shuffle_i32x4(rows[j], rows[4 + j], 0x44);
+            const auto high_parts = _mm512_shuffle_i32x4(rows[j], rows[4 + j], 0xee);
+            const auto low_parts_next = _mm512_shuffle_i32x4(rows[8 + j], rows[12 + j], 0x44);
+            const auto high_parts_next = _mm512_shuffle_i32x4(rows[8 + j], rows[12 + j], 0xee);
+            const __m512i words[4] = {_mm512_shuffle_i32x4(low_parts, low_parts_next, 0x88),
+                                                  _mm512_shuffle_i32x4(low_parts, low_parts_next, 0xdd),
+                                                  _mm512_shuffle_i32x4(high_parts, high_parts_next, 0x88),
+                                                  _mm512_shuffle_i32x4(high_parts, high_parts_next, 0xdd)};
+            for (auto k = 0U; k < 4; ++k) {
+                out[4 * k + j] = _mm512_shuffle_epi8(words[k], swap_bytes);
+            }
+        }
+    }
+
+    [[gnu::target("avx512f")]] static __m512i xor3(__m512i x, __m512i y, __m512i z) {
+        return _mm512_ternarylogic_epi32(x, y, z, 0x96);
+    }
+    [[gnu::target("avx512f")]] static __m512i add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+};
+#endif
+
+// SHA-256 of every message with engine::lanes messages in flight. A lane compresses the whole blocks of its
+// message where they are, then the padded last one or two blocks from its own buffer. When its message is
+// done the lane takes the next one, so messages of different lengths keep the lanes busy. Lanes without a
+// message repeat the blocks of a busy lane and their results are dropped
+template <typename engine>
+void hash_lanes(std::span<const std::span<const uint8_t>> messages, std::span<SHA256::digest_t> digests) {
+    constexpr auto lanes = engine::lanes;
+    constexpr auto idle = ~size_t(0);
+    struct Lane {
+        size_t message = idle;
+        const uint8_t *blocks = nullptr;
+        size_t count = 0;
+        bool padded = false;
+        size_t padded_count = 0;
+        std::array<uint8_t, 2 * block_size> padding;
+    };
+    std::array<Lane, lanes> lane_of;
+    std::array<uint32_t, 8 * lanes> states;
+    std::array<const uint8_t *, lanes> pointers;
+    size_t next = 0;
+
+    const auto start = [&](size_t lane) {
+        auto &current = lane_of[lane];
+        current.message = next < messages.size() ? next++ : idle;
+        if (current.message == idle) {
+            return;
+        }
+        const auto message = messages[current.message];
+        for (size_t i = 0; i < 8; ++i) {
+            states[i * lanes + lane] = SHA256::initial_state[i];
+        }
+        // as in finalize: 0x80, zeros and the length in bits at the end of the last block
+        const auto whole = message.size() - message.size() % block_size;
+        const auto rest = message.size() - whole;
+        const auto bits = uint64_t(message.size()) * 8;
+        current.padding.fill(0);
+        std::copy(message.begin() + whole, message.end(), current.padding.begin());
+        current.padding[rest] = 0x80;
+        current.padded_count = rest < block_size - 8 ? 1 : 2;
+        store_big_endian(uint32_t(bits >> 32), &current.padding[current.padded_count * block_size - 8]);
+        store_big_endian(uint32_t(bits), &current.padding[current.padded_count * block_size - 4]);
+
+        current.blocks = message.data();
+        current.count = whole / block_size;
+        current.padded = false;
+        if (current.count == 0) {
+            current.blocks = current.padding.data();
+            current.count = current.padded_count;
+            current.padded = true;
+        }
+    };
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        start(lane);
+    }
+    while (true) {
+        // as many blocks as every busy lane has left before it moves on
+        auto count = idle;
+        const uint8_t *busy = nullptr;
+        for (const auto &current : lane_of) {
+            if (current.message != idle) {
+                count = std::min(count, current.count);
+                busy = current.blocks;
+            }
+        }
+        if (busy == nullptr) {
+            return;
+        }
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            pointers[lane] = lane_of[lane].message != idle ? lane_of[lane].blocks : busy;
+        }
+        engine::compress(states.data(), pointers.data(), count);
+
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            auto &current = lane_of[lane];
+            if (current.message == idle) {
+                continue;
+            }
+            current.blocks += count * block_size;
+            current.count -= count;
+            if (current.count > 0) {
+                continue;
+            }
+            if (!current.padded) {
+                current.blocks = current.padding.data();
+                current.count = current.padded_count;
+                current.padded = true;
+                continue;
+            }
+            auto &digest = digests[current.message];
+            for (size_t i = 0; i < 8; ++i) {
+                store_big_endian(states[i * lanes + lane], &digest[4 * i]);
+            }
+            start(lane);
+        }
+    }
+}
+
+// digests[i] = SHA256::hash(messages[i]) for many independent messages, 16 at a time in the lanes of
+// AVX-512. SHA-NI hashing one message after the other beats the 8 lanes of AVX2, which are used only on
+// processors without it. Fewer messages than lanes are hashed one after the other
+inline void hash_batch(std::span<const std::span<const uint8_t>> messages,
+                       std::span<SHA256::digest_t> digests) {
+#ifdef UNDERSTANDING_CRYPTO_X86
+    if (AVX512::supported() && messages.size() >= AVX512::lanes) {
+        hash_lanes<AVX512>(messages, digests);
+        return;
+    }
+    if (engine() == Engine::SOFTWARE && AVX2::supported() && messages.size() >= AVX2::lanes) {
+        hash_lanes<AVX2>(messages, digests);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < messages.size(); ++i) {
+        digests[i] = SHA256::hash(messages[i]);
+    }
+}
+} // namespace understanding_crypto::sha
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef UNDERSTANDING_CRYPTO_THREAD_POOL_H
+#define UNDERSTANDING_CRYPTO_THREAD_POOL_H
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace understanding_crypto {
+// fixed set of threads with one deque of task indices each. A thread takes tasks from the front of its own
+// deque and steals from the back of the others once it runs dry, so uneven tasks still keep every thread
+// busy. The thread calling for_each is one of the workers.
+class Thread_Pool {
+  public:
+    static size_t default_threads() { return std::max(1U, std::thread::hardware_concurrency()); }
+
+    explicit Thread_Pool(size_t threads = default_threads())
+        : thread_count(std::max<size_t>(threads, 1)), queues(std::make_unique<Queue[]>(thread_count)) {
+        for (auto i = 1U; i < thread_count; ++i) {
+            workers.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    Thread_Pool(const Thread_Pool &) = delete;
+    Thread_Pool &operator=(const Thread_Pool &) = delete;
+
+    ~Thread_Pool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    // including the calling thread
+    size_t size() const { return thread_count; }
+
+    // calls task(i) for every i in [0, count) and returns when all calls are done. Each thread starts on a
+    // contiguous range of indices. Not reentrant, one for_each at a time.
+    void for_each(size_t count, const std::function<void(size_t)> &task) {
+        if (count == 0) {
+            return;
+        }
+        {
+            std::lock_guard lock(mutex);
+            current = &task;
+            remaining = count;
+            for (auto i = 0U; i < thread_count; ++i) {
+                std::lock_guard queue_lock(queues[i].mutex);
+                for (auto index = count * i / thread_count; index < count * (i + 1) / thread_count; ++index) {
+                    queues[i].tasks.push_back(index);
+                }
+            }
+            ++generation;
+        }
+        wake.notify_all();
+
+        work(0);
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [this] { return remaining == 0; });
+        current = nullptr;
+    }
+
+  private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void run(size_t self) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            work(self);
+        }
+    }
+
+    void work(size_t self) {
+        size_t index;
+        while (take(self, index)) {
+            (*current)(index);
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    bool take(size_t self, size_t &index) {
+        {
+            auto &own = queues[self];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty()) {
+                index = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        for (auto i = 1U; i < thread_count; ++i) {
+            auto &victim = queues[(self + i) % thread_count];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                index = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t thread_count;
+    std::unique_ptr<Queue[]> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)> *current = nullptr;
+    std::atomic<size_t> remaining = 0;
+    size_t generation = 0;
+    bool stopping = false;
+};
+} // namespace understanding_crypto
+
+#endif
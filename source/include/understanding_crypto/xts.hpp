@@ -0,0 +1,182 @@
+#ifndef UNDERSTANDING_CRYPTO_XTS_H
+#define UNDERSTANDING_CRYPTO_XTS_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include <understanding_crypto/aes.hpp>
+
+namespace understanding_crypto::aes {
+// XTS-AES (IEEE 1619, NIST SP 800-38E): every sector is encrypted under its own tweak, the encrypted
+// sector number. A sector is empty or at least one block, a partial last block is handled by ciphertext
+// stealing, shorter sectors throw std::invalid_argument. The data key and the tweak key have to differ.
+// Both expanded keys are referenced, temporaries are rejected at compile time. A key_schedule_t for the data
+// key speeds up decryption.
+template <typename data_keys_t, typename tweak_keys_t = data_keys_t> class XTS {
+  public:
+    static constexpr size_t block_size = sizeof(state_t);
+    // tweaks computed ahead per batch, one 4 KiB sector
+    static constexpr size_t batch_blocks = 256;
+
+    XTS(const data_keys_t &data_keys, const tweak_keys_t &tweak_keys)
+        : data_keys(data_keys), tweak_keys(tweak_keys), bulk_keys(data_keys) {
+        // IEEE 1619 5.1 requires two independent keys
+        const auto &data_encryption = AES::Common::encryption_keys(data_keys);
+        const auto &tweak_encryption = AES::Common::encryption_keys(tweak_keys);
+        if constexpr (std::is_same_v<decltype(data_encryption), decltype(tweak_encryption)>) {
+            if (data_encryption == tweak_encryption) {
+                throw std::invalid_argument("XTS data key and tweak key are equal");
+            }
+        }
+    }
+    XTS(const data_keys_t &&, const tweak_keys_t &) = delete;
+    XTS(const data_keys_t &, const tweak_keys_t &&) = delete;
+    XTS(const data_keys_t &&, const tweak_keys_t &&) = delete;
+
+    // output may be the same memory as input, both are sector long
+    void encrypt_sector(uint64_t sector, std::span<const uint8_t> input, std::span<uint8_t> output) const {
+        process_sector<true>(sector, input, output);
+    }
+
+    void decrypt_sector(uint64_t sector, std::span<const uint8_t> input, std::span<uint8_t> output) const {
+        process_sector<false>(sector, input, output);
+    }
+
+    // consecutive sectors starting at first_sector, only the last one may be shorter than sector_size
+    void encrypt_sectors(uint64_t first_sector, size_t sector_size, std::span<const uint8_t> input,
+                         std::span<uint8_t> output) const {
+        for (size_t offset = 0; offset < input.size(); offset += sector_size, ++first_sector) {
+            const auto size = std::min(sector_size, input.size() - offset);
+            encrypt_sector(first_sector, input.subspan(offset, size), output.subspan(offset, size));
+        }
+    }
+
+    void decrypt_sectors(uint64_t first_sector, size_t sector_size, std::span<const uint8_t> input,
+                         std::span<uint8_t> output) const {
+        for (size_t offset = 0; offset < input.size(); offset += sector_size, ++first_sector) {
+            const auto size = std::min(sector_size, input.size() - offset);
+            decrypt_sector(first_sector, input.subspan(offset, size), output.subspan(offset, size));
+        }
+    }
+
+    // element of GF(2^128) in the little endian convention of IEEE 1619, bit 0 of byte 0 is x^0
+    struct tweak_t {
+        uint64_t low;
+        uint64_t high;
+
+        static tweak_t load(const uint8_t *bytes) {
+            tweak_t tweak;
+            std::memcpy(&tweak.low, bytes, sizeof(low));
+            std::memcpy(&tweak.high, bytes + sizeof(low), sizeof(high));
+            if constexpr (std::endian::native == std::endian::big) {
+                tweak.low = std::byteswap(tweak.low);
+                tweak.high = std::byteswap(tweak.high);
+            }
+            return tweak;
+        }
+
+        void store(uint8_t *bytes) const {
+            auto words = std::array{low, high};
+            if constexpr (std::endian::native == std::endian::big) {
+                words = {std::byteswap(low), std::byteswap(high)};
+            }
+            std::memcpy(bytes, words.data(), sizeof(words));
+        }
+
+        // multiplication by x, reduced by x^128 + x^7 + x^2 + x + 1
+        void next() {
+            const auto carry = high >> 63;
+            high = (high << 1) | (low >> 63);
+            low = (low << 1) ^ (0x87 & (0 - carry));
+        }
+    };
+
+    tweak_t initial_tweak(uint64_t sector) const {
+        std::array<uint8_t, block_size> block{};
+        tweak_t{sector, 0}.store(block.data());
+        AES::encrypt(block128_t{block}, tweak_keys);
+        return tweak_t::load(block.data());
+    }
+
+  private:
+    template <bool encrypting>
+    void process_sector(uint64_t sector, std::span<const uint8_t> input, std::span<uint8_t> output) const {
+        if (input.size() > 0 && input.size() < block_size) {
+            throw std::invalid_argument("XTS sector shorter than one block");
+        }
+        const auto partial = input.size() % block_size;
+        // with a partial block the last whole block takes part in the stealing
+        const auto bulk = (input.size() / block_size - (partial != 0)) * block_size;
+        auto tweak = initial_tweak(sector);
+
+        std::array<uint8_t, batch_blocks * block_size> tweaks;
+        for (size_t offset = 0; offset < bulk; offset += tweaks.size()) {
+            const auto size = std::min(tweaks.size(), bulk - offset);
+            for (size_t i = 0; i < size; i += block_size) {
+                tweak.store(&tweaks[i]);
+                tweak.next();
+            }
+
+            const auto batch = output.subspan(offset, size);
+            for (auto i = 0U; i < size; ++i) {
+                batch[i] = input[offset + i] ^ tweaks[i];
+            }
+            encrypting ? AES::encrypt_blocks(batch, bulk_keys) : AES::decrypt_blocks(batch, bulk_keys);
+            for (auto i = 0U; i < size; ++i) {
+                batch[i] ^= tweaks[i];
+            }
+        }
+
+        if (partial != 0) {
+            steal<encrypting>(tweak, input.subspan(bulk), output.subspan(bulk));
+        }
+    }
+
+    // the last whole block and the partial one. Encryption uses the tweaks of both blocks in order,
+    // decryption has to undo the second one first
+    template <bool encrypting>
+    void steal(tweak_t tweak, std::span<const uint8_t> input, std::span<uint8_t> output) const {
+        const auto partial = input.size() - block_size;
+        auto second = tweak;
+        second.next();
+        if constexpr (!encrypting) {
+            std::swap(tweak, second);
+        }
+
+        std::array<uint8_t, block_size> block;
+        std::copy_n(input.begin(), block_size, block.begin());
+        crypt_block<encrypting>(block, tweak);
+
+        auto stolen = block;
+        std::copy_n(&input[block_size], partial, stolen.begin());
+        std::copy_n(block.begin(), partial, &output[block_size]);
+        crypt_block<encrypting>(stolen, second);
+        std::copy(stolen.begin(), stolen.end(), output.begin());
+    }
+
+    template <bool encrypting> void crypt_block(std::array<uint8_t, block_size> &block, tweak_t tweak) const {
+        std::array<uint8_t, block_size> mask;
+        tweak.store(mask.data());
+        for (auto i = 0U; i < block_size; ++i) {
+            block[i] ^= mask[i];
+        }
+        encrypting ? AES::encrypt(block128_t{block}, data_keys) : AES::decrypt(block128_t{block}, data_keys);
+        for (auto i = 0U; i < block_size; ++i) {
+            block[i] ^= mask[i];
+        }
+    }
+
+    const data_keys_t &data_keys;
+    const tweak_keys_t &tweak_keys;
+    AES::Bulk_Keys<data_keys_t> bulk_keys;
+};
+} // namespace understanding_crypto::aes
+
+#endif
@@ -30,6 +30,269 @@ TEST_SUITE("examples") {
     }
 }
 
+// FIPS-197 Appendix C example vectors, shared by every engine
+struct appendix_c {
+    static constexpr state_t plain = {0x00112233, 0x44556677, 0x8899aabb, 0xccddeeff};
+    static constexpr state_t cipher128 = {0x69c4e0d8, 0x6a7b0430, 0xd8cdb780, 0x70b4c55a};
+    static constexpr state_t cipher192 = {0xdda97ca4, 0x864cdfe0, 0x6eaf70a0, 0xec0d7191};
+    static constexpr state_t cipher256 = {0x8ea2b7ca, 0x516745bf, 0xeafc4990, 0x4b496089};
+
+    template <typename key_t> static auto expanded_key() {
+        std::array<uint8_t, key_t::extent> key;
+        for (auto i = 0U; i < key.size(); ++i) {
+            key[i] = i;
+        }
+        return AES::Common::expand_key(key_t{key});
+    }
+
+    template <typename key_t> static auto key_schedule() {
+        std::array<uint8_t, key_t::extent> key;
+        for (auto i = 0U; i < key.size(); ++i) {
+            key[i] = i;
+        }
+        return AES::Common::expand_key_schedule(key_t{key});
+    }
+
+    template <typename engine_t> static void check() {
+        const auto keys128 = expanded_key<key128_t>();
+        const auto keys192 = expanded_key<key192_t>();
+        const auto keys256 = expanded_key<key256_t>();
+
+        auto data = plain;
+        engine_t::encrypt(data, keys128);
+        CHECK_EQ(data, cipher128);
+        engine_t::decrypt(data, keys128);
+        CHECK_EQ(data, plain);
+
+        engine_t::encrypt(data, keys192);
+        CHECK_EQ(data, cipher192);
+        engine_t::decrypt(data, keys192);
+        CHECK_EQ(data, plain);
+
+        engine_t::encrypt(data, keys256);
+        CHECK_EQ(data, cipher256);
+        engine_t::decrypt(data, keys256);
+        CHECK_EQ(data, plain);
+    }
+
+    // equivalent inverse cipher with the cached decryption keys
+    template <typename engine_t> static void check_schedule() {
+        const auto schedule128 = key_schedule<key128_t>();
+        const auto schedule192 = key_schedule<key192_t>();
+        const auto schedule256 = key_schedule<key256_t>();
+
+        auto data = cipher128;
+        engine_t::decrypt(data, schedule128);
+        CHECK_EQ(data, plain);
+        data = cipher192;
+        engine_t::decrypt(data, schedule192);
+        CHECK_EQ(data, plain);
+        data = cipher256;
+        engine_t::decrypt(data, schedule256);
+        CHECK_EQ(data, plain);
+    }
+};
+
+TEST_SUITE("engines") {
+    TEST_CASE("reference") { appendix_c::check<AES::Reference>(); }
+    TEST_CASE("dispatched") { appendix_c::check<AES>(); }
+    TEST_CASE("t-table") { appendix_c::check<AES::TTable>(); }
+#ifdef UNDERSTANDING_CRYPTO_X86
+    TEST_CASE("aes-ni") {
+        if (!AES::AESNI::supported()) {
+            return;
+        }
+        appendix_c::check<AES::AESNI>();
+    }
+#endif
+}
+
+TEST_SUITE("equivalent inverse cipher") {
+    TEST_CASE("reference") { appendix_c::check_schedule<AES::Reference>(); }
+    TEST_CASE("dispatched") { appendix_c::check_schedule<AES>(); }
+    TEST_CASE("t-table") { appendix_c::check_schedule<AES::TTable>(); }
+    TEST_CASE("t-table blocks") {
+        const auto keys = appendix_c::expanded_key<key256_t>();
+        std::array<state_t, 3> blocks = {appendix_c::plain, appendix_c::plain, appendix_c::plain};
+        AES::TTable::encrypt(blocks, keys);
+        CHECK_EQ(blocks[1], appendix_c::cipher256);
+        // plain keys are converted once for all blocks
+        AES::TTable::decrypt(blocks, keys);
+        CHECK_EQ(blocks[2], appendix_c::plain);
+        AES::TTable::encrypt(blocks, appendix_c::key_schedule<key256_t>());
+        AES::TTable::decrypt(blocks, appendix_c::key_schedule<key256_t>());
+        CHECK_EQ(blocks[0], appendix_c::plain);
+    }
+#ifdef UNDERSTANDING_CRYPTO_X86
+    TEST_CASE("aes-ni") {
+        if (AES::AESNI::supported()) {
+            appendix_c::check_schedule<AES::AESNI>();
+        }
+    }
+#endif
+    TEST_CASE("decryption keys") {
+        const auto schedule = appendix_c::key_schedule<key128_t>();
+        CHECK_EQ(schedule.decryption.front(), schedule.encryption.back());
+        CHECK_EQ(schedule.decryption.back(), schedule.encryption.front());
+        auto mixed = schedule.encryption[9];
+        CHECK_EQ(schedule.decryption[1], AES::Decryption::mix_columns(mixed));
+    }
+}
+
+TEST_SUITE("byte blocks") {
+    TEST_CASE("single block") {
+        const auto keys = appendix_c::expanded_key<key128_t>();
+        std::array<uint8_t, 16> block;
+        for (auto i = 0U; i < block.size(); ++i) {
+            block[i] = i * 0x11;
+        }
+        AES::encrypt(block128_t{block}, keys);
+        CHECK_EQ(AES::Common::load_block(block), appendix_c::cipher128);
+        AES::decrypt(block128_t{block}, keys);
+        CHECK_EQ(AES::Common::load_block(block), appendix_c::plain);
+    }
+}
+
+TEST_SUITE("bitsliced") {
+    // 16 blocks cover every byte value once
+    std::array<state_t, 16> all_bytes() {
+        std::array<state_t, 16> blocks;
+        for (auto i = 0U; i < 256; ++i) {
+            auto &word = blocks[i / 16][(i / 4) % 4];
+            word = (word << 8) | i;
+        }
+        return blocks;
+    }
+
+    TEST_CASE("substitute bytes") {
+        const auto input = all_bytes();
+        for (auto offset = 0U; offset < input.size(); offset += AES::Bitsliced::block_count) {
+            std::array<state_t, AES::Bitsliced::block_count> blocks;
+            std::copy_n(input.begin() + offset, blocks.size(), blocks.begin());
+
+            auto planes = AES::Bitsliced::pack(blocks);
+            AES::Bitsliced::substitute_bytes(planes);
+            AES::Bitsliced::unpack(planes, blocks);
+            for (auto i = 0U; i < blocks.size(); ++i) {
+                auto expected = input[offset + i];
+                CHECK_EQ(blocks[i], AES::Encryption::substitute_bytes(expected));
+            }
+
+            planes = AES::Bitsliced::pack(blocks);
+            AES::Bitsliced::inverse_substitute_bytes(planes);
+            AES::Bitsliced::unpack(planes, blocks);
+            for (auto i = 0U; i < blocks.size(); ++i) {
+                CHECK_EQ(blocks[i], input[offset + i]);
+            }
+        }
+    }
+
+    TEST_CASE("matches reference") {
+        const auto keys128 = appendix_c::expanded_key<key128_t>();
+        const auto keys256 = appendix_c::expanded_key<key256_t>();
+        // one full group and a partial one
+        auto blocks = std::array<state_t, 11>{};
+        for (auto i = 0U; i < blocks.size(); ++i) {
+            blocks[i] = appendix_c::plain;
+            blocks[i][3] += i;
+        }
+
+        auto expected = blocks;
+        for (auto &block : expected) {
+            AES::Reference::encrypt(block, keys128);
+        }
+        auto actual = blocks;
+        AES::Bitsliced::encrypt(actual, keys128);
+        CHECK_EQ(actual, expected);
+        AES::Bitsliced::decrypt(actual, keys128);
+        CHECK_EQ(actual, blocks);
+
+        expected = blocks;
+        for (auto &block : expected) {
+            AES::Reference::encrypt(block, keys256);
+        }
+        const auto sliced_keys = AES::Bitsliced::slice_keys(keys256);
+        AES::Bitsliced::encrypt(actual, sliced_keys);
+        CHECK_EQ(actual, expected);
+        AES::Bitsliced::decrypt(actual, sliced_keys);
+        CHECK_EQ(actual, blocks);
+    }
+}
+
+TEST_SUITE("bulk") {
+    template <AES::Bulk_Engine engine> void check_blocks() {
+        const auto keys192 = appendix_c::expanded_key<key192_t>();
+        // two full groups of the widest kernel, one of the 8 block kernel and a tail
+        auto blocks = std::array<state_t, 45>{};
+        for (auto i = 0U; i < blocks.size(); ++i) {
+            blocks[i] = appendix_c::plain;
+            blocks[i][0] ^= i << 24;
+        }
+
+        auto expected = blocks;
+        for (auto &block : expected) {
+            AES::Reference::encrypt(block, keys192);
+        }
+        auto actual = blocks;
+        AES::encrypt_blocks<engine>(actual, keys192);
+        CHECK_EQ(actual, expected);
+        AES::decrypt_blocks<engine>(actual, keys192);
+        CHECK_EQ(actual, blocks);
+
+        const auto schedule192 = appendix_c::key_schedule<key192_t>();
+        AES::encrypt_blocks<engine>(actual, schedule192);
+        CHECK_EQ(actual, expected);
+        AES::decrypt_blocks<engine>(actual, schedule192);
+        CHECK_EQ(actual, blocks);
+
+        const AES::Bulk_Keys bulk_keys{schedule192, engine};
+        AES::encrypt_blocks<engine>(actual, bulk_keys);
+        CHECK_EQ(actual, expected);
+        AES::decrypt_blocks<engine>(actual, bulk_keys);
+        CHECK_EQ(actual, blocks);
+
+        // the same blocks in input byte order
+        std::array<uint8_t, blocks.size() * 16> bytes;
+        std::array<uint8_t, blocks.size() * 16> expected_bytes;
+        for (auto i = 0U; i < blocks.size(); ++i) {
+            AES::Common::store_block(blocks[i], block128_t{&bytes[i * 16], 16});
+            AES::Common::store_block(expected[i], block128_t{&expected_bytes[i * 16], 16});
+        }
+        const auto plain_bytes = bytes;
+        AES::encrypt_blocks<engine>(bytes, keys192);
+        CHECK(bytes == expected_bytes);
+        AES::decrypt_blocks<engine>(bytes, keys192);
+        CHECK(bytes == plain_bytes);
+    }
+
+    TEST_CASE("software") { check_blocks<AES::Bulk_Engine::SOFTWARE>(); }
+#ifdef UNDERSTANDING_CRYPTO_X86
+    TEST_CASE("aes-ni") {
+        if (AES::AESNI::supported()) {
+            check_blocks<AES::Bulk_Engine::AESNI>();
+        }
+    }
+    TEST_CASE("vaes 256") {
+        if (AES::VAES256::supported()) {
+            check_blocks<AES::Bulk_Engine::VAES256>();
+        }
+    }
+    TEST_CASE("vaes 512") {
+        if (AES::VAES512::supported()) {
+            check_blocks<AES::Bulk_Engine::VAES512>();
+        }
+    }
+#endif
+    TEST_CASE("dispatched") {
+        const auto keys = appendix_c::expanded_key<key128_t>();
+        auto blocks = std::array<state_t, 3>{appendix_c::plain, appendix_c::plain, appendix_c::plain};
+        AES::encrypt_blocks(blocks, keys);
+        CHECK_EQ(blocks[2], appendix_c::cipher128);
+        AES::decrypt_blocks(blocks, keys);
+        CHECK_EQ(blocks[2], appendix_c::plain);
+    }
+}
+
 TEST_SUITE("encrypt") {
     TEST_CASE("substitute bytes") {
         auto state = state_t{1, 2, 3, 4};
@@ -40,13 +303,13 @@ TEST_SUITE("encrypt") {
     TEST_CASE("row shift") {
         auto state = state_t{0x01020304, 0x02030405, 0x03040506, 0x04050607};
 
-        constexpr auto expected = state_t{0x01020304, 0x03040502, 0x05060304, 0x07040506};
+        constexpr auto expected = state_t{0x01030507, 0x02040604, 0x03050305, 0x04020406};
         CHECK_EQ(AES::Encryption::row_shift(state), expected);
     }
     TEST_CASE("column mix") {
-        auto state = state_t{1, 2, 3, 4};
+        auto state = state_t{0, 0, 0, 0x01020304};
 
-        constexpr auto expected = state_t{3, 4, 9, 10};
+        constexpr auto expected = state_t{0, 0, 0, 0x0304090a};
         CHECK_EQ(AES::Encryption::mix_columns(state), expected);
     }
 }
@@ -59,15 +322,15 @@ TEST_SUITE("decrypt") {
         CHECK_EQ(AES::Decryption::substitute_bytes(state), expected);
     }
     TEST_CASE("row shift") {
-        auto state = state_t{0x01020304, 0x03040502, 0x05060304, 0x07040506};
+        auto state = state_t{0x01030507, 0x02040604, 0x03050305, 0x04020406};
 
         constexpr auto expected = state_t{0x01020304, 0x02030405, 0x03040506, 0x04050607};
         CHECK_EQ(AES::Decryption::row_shift(state), expected);
     }
     TEST_CASE("column mix") {
-        auto state = state_t{3, 4, 9, 10};
+        auto state = state_t{0, 0, 0, 0x0304090a};
 
-        constexpr auto expected = state_t{1, 2, 3, 4};
+        constexpr auto expected = state_t{0, 0, 0, 0x01020304};
         CHECK_EQ(AES::Decryption::mix_columns(state), expected);
     }
 }
@@ -79,9 +342,9 @@ TEST_SUITE("common") {
         key128_t key_s{key};
         const auto expanded = AES::Common::expand_key(key_s);
 
-        constexpr auto expected_0 = state_t{0x2b28ab09, 0x7eaef7cf, 0x15d2154f, 0x16a6883c};
-        constexpr auto expected_1 = state_t{0xa088232a, 0xfa54a36c, 0xfe2c3976, 0x17b13905};
-        constexpr auto expected_10 = state_t{0xd0c9e1b6, 0x14ee3f63, 0xf9250c0c, 0xa889c8a6};
+        constexpr auto expected_0 = state_t{0x2b7e1516, 0x28aed2a6, 0xabf71588, 0x09cf4f3c};
+        constexpr auto expected_1 = state_t{0xa0fafe17, 0x88542cb1, 0x23a33939, 0x2a6c7605};
+        constexpr auto expected_10 = state_t{0xd014f9a8, 0xc9ee2589, 0xe13f0cc8, 0xb6630ca6};
         CHECK_EQ(expanded[0], expected_0);
         CHECK_EQ(expanded[1], expected_1);
         CHECK_EQ(expanded[10], expected_10);
@@ -92,9 +355,9 @@ TEST_SUITE("common") {
         key192_t key_s{key};
         const auto expanded = AES::Common::expand_key(key_s);
 
-        constexpr auto expected_0 = state_t{0x8edac880, 0x730e1090, 0xb064f379, 0xf7522be5};
-        constexpr auto expected_1 = state_t{0x6252fe24, 0xf82c0c02, 0xea6b91f5, 0xd27bf7a5};
-        constexpr auto expected_12 = state_t{0xe9448e01, 0x8b8ccc00, 0xa0777222, 0x6f3c0402};
+        constexpr auto expected_0 = state_t{0x8e73b0f7, 0xda0e6452, 0xc810f32b, 0x809079e5};
+        constexpr auto expected_1 = state_t{0x62f8ead2, 0x522c6b7b, 0xfe0c91f7, 0x2402f5a5};
+        constexpr auto expected_12 = state_t{0xe98ba06f, 0x448c773c, 0x8ecc7204, 0x01002202};
         CHECK_EQ(expanded[0], expected_0);
         CHECK_EQ(expanded[1], expected_1);
         CHECK_EQ(expanded[12], expected_12);
@@ -106,17 +369,60 @@ TEST_SUITE("common") {
         key256_t key_s{key};
         const auto expanded = AES::Common::expand_key(key_s);
 
-        constexpr auto expected_0 = state_t{0x60152b85, 0x3dca737d, 0xeb71ae77, 0x10bef081};
-        constexpr auto expected_1 = state_t{0x1f3b2d09, 0x35619814, 0x2c0810df, 0x07d7a3f4};
-        constexpr auto expected_14 = state_t{0xfee60470, 0x48186d6c, 0x908df363, 0xd10b441e};
+        constexpr auto expected_0 = state_t{0x603deb10, 0x15ca71be, 0x2b73aef0, 0x857d7781};
+        constexpr auto expected_1 = state_t{0x1f352c07, 0x3b6108d7, 0x2d9810a3, 0x0914dff4};
+        constexpr auto expected_14 = state_t{0xfe4890d1, 0xe6188d0b, 0x046df344, 0x706c631e};
         CHECK_EQ(expanded[0], expected_0);
         CHECK_EQ(expanded[1], expected_1);
         CHECK_EQ(expanded[14], expected_14);
     }
-    TEST_CASE("transpose") {
-        state_t state = {0x01020304, 0x05060708, 0x090a0b0c, 0x0d0e0f10};
-        constexpr auto expected = state_t{0x0105090d, 0x02060a0e, 0x03070b0f, 0x04080c10};
-        CHECK_EQ(AES::Common::transpose(state), expected);
+    TEST_CASE("expand key at compile time") {
+        static constexpr std::array<uint8_t, 16> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                        0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+        constexpr auto expanded = AES::Common::expand_key(std::span<const uint8_t, 16>{key});
+        static_assert(expanded[10] == state_t{0xd014f9a8, 0xc9ee2589, 0xe13f0cc8, 0xb6630ca6});
+
+        constexpr auto schedule = AES::Common::expand_key_schedule(std::span<const uint8_t, 16>{key});
+        static_assert(schedule.decryption.front() == expanded.back());
+        CHECK_EQ(schedule.encryption, expanded);
+    }
+    TEST_CASE("expand keys in batches") {
+        const auto check_batch = []<typename key_t, size_t COUNT>() {
+            std::array<std::array<uint8_t, key_t::extent>, COUNT> bytes;
+            for (auto k = 0U; k < COUNT; ++k) {
+                for (auto i = 0U; i < key_t::extent; ++i) {
+                    bytes[k][i] = k * 37 + i * 11;
+                }
+            }
+            const auto keys = [&]<size_t... K>(std::index_sequence<K...>) {
+                return std::array{key_t{bytes[K]}...};
+            }(std::make_index_sequence<COUNT>());
+
+            const auto expanded = AES::Common::expand_keys(keys);
+            const auto schedules = AES::Common::expand_key_schedules(keys);
+            for (auto k = 0U; k < COUNT; ++k) {
+                CHECK_EQ(expanded[k], AES::Common::expand_key(keys[k]));
+                CHECK_EQ(schedules[k].decryption, AES::Common::expand_key_schedule(keys[k]).decryption);
+            }
+        };
+        check_batch.template operator()<key128_t, 4>();
+        check_batch.template operator()<key128_t, 16>();
+        check_batch.template operator()<key192_t, 8>();
+        // a partial group of four falls back to expand_key
+        check_batch.template operator()<key256_t, 7>();
+    }
+    TEST_CASE("load and store block") {
+        std::array<uint8_t, 16> bytes;
+        for (auto i = 0U; i < bytes.size(); ++i) {
+            bytes[i] = i + 1;
+        }
+        const auto state = AES::Common::load_block(bytes);
+        constexpr auto expected = state_t{0x01020304, 0x05060708, 0x090a0b0c, 0x0d0e0f10};
+        CHECK_EQ(state, expected);
+
+        std::array<uint8_t, 16> stored{};
+        AES::Common::store_block(state, stored);
+        CHECK_EQ(stored, bytes);
     }
     TEST_CASE("add round key") {
         auto state = state_t{1, 2, 3, 4};
@@ -0,0 +1,55 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/barrett.hpp>
+
+#include <random>
+
+namespace understanding_crypto {
+using namespace test;
+
+namespace {
+template <size_t BITS> void check_against_division(std::mt19937_64 &random, const uint_t<BITS> &n) {
+    const Barrett<BITS> context{n};
+    for (auto i = 0; i < 200; ++i) {
+        const auto a = random_below(random, n);
+        const auto b = random_below(random, n);
+        const auto product = uint_t<2 * BITS>::from_multiplication_of(a, b);
+        CHECK((context.multiply(a, b) == product % n));
+        CHECK((context.square(a) == uint_t<2 * BITS>::from_square_of(a) % n));
+    }
+    // the largest input, (n - 1)^2
+    const auto largest = n - 1;
+    CHECK((context.multiply(largest, largest) == uint_t<2 * BITS>::from_square_of(largest) % n));
+}
+} // namespace
+
+TEST_SUITE("barrett") {
+    TEST_CASE("small moduli") {
+        std::mt19937_64 random(18);
+        for (const uint64_t n : {2ULL, 3ULL, 1000003ULL, 0x8000'0000'0000'0000ULL, ~0ULL}) {
+            check_against_division(random, uint_t<64>{n});
+        }
+    }
+
+    TEST_CASE("random moduli of every length") {
+        std::mt19937_64 random(19);
+        for (auto i = 0; i < 20; ++i) {
+            uint_t<521> n{0};
+            for (auto &word : n.internal_main) {
+                word = random();
+            }
+            // from full length down to a single word
+            n = n >> (random() % 520);
+            n.internal_main[0] |= 2;
+            check_against_division(random, n);
+        }
+    }
+
+    TEST_CASE("powers of two") {
+        std::mt19937_64 random(20);
+        check_against_division(random, uint_t<256>{1} << 255);
+        check_against_division(random, uint_t<256>{1} << 128);
+    }
+}
+} // namespace understanding_crypto
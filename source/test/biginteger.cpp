@@ -1,7 +1,33 @@
+#include "numbers.hpp"
+
 #include <doctest/doctest.h>
 #include <understanding_crypto/biginteger.hpp>
 
+#include <random>
+#include <stdexcept>
+#include <utility>
+
 namespace understanding_crypto {
+using namespace test;
+
+namespace {
+// one bit of quotient per step, shift and subtract
+template <size_t lhs_bits, size_t rhs_bits>
+auto slow_divide(const uint_t<lhs_bits> &u, const uint_t<rhs_bits> &v) {
+    uint_t<lhs_bits> quotient{0};
+    uint_t<rhs_bits + 1> remainder{0};
+    for (size_t bit = lhs_bits; bit-- > 0;) {
+        remainder = remainder << 1;
+        remainder.internal_main[0] |= (u[bit / u.bits_in_word] >> (bit % u.bits_in_word)) & 1;
+        if (remainder >= v) {
+            remainder = remainder - v;
+            quotient.internal_main[bit / u.bits_in_word] |= size_t(1) << (bit % u.bits_in_word);
+        }
+    }
+    return std::pair{quotient, uint_t<rhs_bits>{remainder}};
+}
+
+} // namespace
 
 TEST_SUITE("examples") {}
 
@@ -24,6 +50,82 @@ TEST_SUITE("same size") {
         CHECK_EQ(b[0], ~size_t(1));
         CHECK_EQ(b[1], 3);
     }
+    TEST_CASE("karatsuba and squaring against schoolbook") {
+        // odd word counts split unevenly, all ones maximizes every carry
+        const auto check = [](auto fill) {
+            uint_t<64 * 67> a, b;
+            for (size_t i = 0; i < a.word_count; ++i) {
+                a.internal_main[i] = fill(i);
+                b.internal_main[i] = fill(i + a.word_count);
+            }
+            std::array<size_t, 2 * a.word_count> expected, expected_square;
+            uint_t<64 * 67>::multiply_words(a.internal_main, b.internal_main, expected);
+            uint_t<64 * 67>::multiply_words(a.internal_main, a.internal_main, expected_square);
+
+            const auto product = uint_t<2 * 64 * 67>::from_multiplication_of(a, b);
+            const auto square = uint_t<2 * 64 * 67>::from_square_of(a);
+            CHECK(product.internal_main == expected);
+            CHECK(square.internal_main == expected_square);
+
+            const auto low = a * b;
+            const auto low_square = a * a;
+            CHECK(std::equal(low.internal_main.begin(), low.internal_main.end(), expected.begin()));
+            CHECK(std::equal(low_square.internal_main.begin(), low_square.internal_main.end(),
+                             expected_square.begin()));
+        };
+        check([](size_t) { return ~size_t(0); });
+        check([](size_t i) { return size_t(0x9e3779b97f4a7c15ULL) * (i + 1) ^ (i << 17); });
+    }
+    TEST_CASE("division against shift and subtract") {
+        std::mt19937_64 random(18);
+        for (auto i = 0; i < 2000; ++i) {
+            const auto u = random_edge_operand<512>(random);
+            auto v = random_edge_operand<256>(random);
+            v.internal_main[0] |= v == uint_t<256>{0};
+            const auto [quotient, remainder] = slow_divide(u, v);
+            CHECK((u / v == quotient));
+            CHECK((u % v == remainder));
+        }
+    }
+    TEST_CASE("compound operators against the binary ones") {
+        std::mt19937_64 random(20);
+        for (auto i = 0; i < 200; ++i) {
+            const auto a = random_edge_operand<320>(random);
+            const auto b = random_edge_operand<320>(random);
+            const auto shift = random() % 400;
+            auto x = a;
+            CHECK(((x += b) == a + b));
+            x = a;
+            CHECK(((x -= b) == a - b));
+            x = a;
+            CHECK(((x *= b) == a * b));
+            x = a;
+            CHECK(((x *= x) == a * a));
+            x = a;
+            CHECK(((x &= b) == (a & b)));
+            x = a;
+            CHECK(((x |= b) == (a | b)));
+            x = a;
+            CHECK(((x ^= b) == (a ^ b)));
+            x = a;
+            CHECK(((x <<= shift) == a << shift));
+            x = a;
+            CHECK(((x >>= shift) == a >> shift));
+        }
+    }
+    TEST_CASE("carry and borrow out") {
+        uint_t<100> a{0};
+        a.internal_main[0] = ~size_t(0);
+        a.internal_main[1] = (size_t(1) << 36) - 1;
+        auto b = a;
+        CHECK_EQ(b.add_with_carry(uint_t<100>{1}), 1);
+        CHECK((b == uint_t<100>{0}));
+        CHECK_EQ(b.subtract_with_borrow(uint_t<100>{1}), 1);
+        CHECK((b == a));
+        CHECK_EQ(b.add_with_carry(uint_t<100>{0}, 0), 0);
+        CHECK_EQ(b.subtract_with_borrow(a, 1), 1);
+        CHECK((b == a));
+    }
     TEST_CASE("binary operations") {
         uint_t<128> a = 0x01020304U;
         uint_t<128> b = 0x04030201U;
@@ -77,6 +179,22 @@ TEST_SUITE("with integer types") {
         CHECK_EQ(e[2], 0xffff'ffff'ffff'fffe);
         CHECK_EQ(e[3], 0x0000'0000'0000'0000);
     }
+    TEST_CASE("division") {
+        uint_t<128> a{};
+        a.internal_main[0] = 0x0123'4567'89ab'cdefULL;
+        a.internal_main[1] = 0xfedc'ba98'7654'3210ULL;
+        const auto [quotient, remainder] = slow_divide(a, uint_t<64>{1000003U});
+        CHECK((a / 1000003U == quotient));
+        CHECK((a % 1000003U == remainder));
+        CHECK((a / ~size_t(0) == slow_divide(a, uint_t<64>{~size_t(0)}).first));
+    }
+    TEST_CASE("division by zero") {
+        const auto a = uint_t<256>{12345U} << 130U;
+        CHECK_THROWS_AS(a / uint_t<256>{0}, std::domain_error);
+        CHECK_THROWS_AS(a % uint_t<256>{0}, std::domain_error);
+        CHECK_THROWS_AS(a / 0U, std::domain_error);
+        CHECK_THROWS_AS(a % 0U, std::domain_error);
+    }
     TEST_CASE("logic operations") {
         uint_t<128> a = 0x01020304U;
         uint32_t b = 0x04030201U;
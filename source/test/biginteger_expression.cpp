@@ -0,0 +1,50 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/biginteger_expression.hpp>
+
+#include <random>
+
+namespace understanding_crypto {
+using namespace test;
+
+TEST_SUITE("expression") {
+    TEST_CASE("one pass against the eager operators") {
+        std::mt19937_64 random(20);
+        for (auto i = 0; i < 500; ++i) {
+            const auto a = random_carry_operand<4096>(random);
+            const auto b = random_carry_operand<4096>(random);
+            const auto c = random_carry_operand<4096>(random);
+            const auto d = random_carry_operand<4096>(random);
+            const uint_t<4096> fused = lazy(a) + b - (lazy(c) ^ d);
+            CHECK((fused == a + b - (c ^ d)));
+
+            uint_t<4096> masked;
+            masked = (lazy(a) & b) | (lazy(c) - d);
+            CHECK((masked == ((a & b) | (c - d))));
+        }
+    }
+
+    TEST_CASE("products and the destination in the expression") {
+        std::mt19937_64 random(21);
+        const auto a = random_carry_operand<256>(random);
+        const auto b = random_carry_operand<256>(random);
+        const auto c = random_carry_operand<256>(random);
+        auto x = c;
+        x = lazy(a * b) + x - a;
+        CHECK((x == a * b + c - a));
+    }
+
+    TEST_CASE("carries run to the width of the destination") {
+        uint_t<64> a{~size_t(0)};
+        const uint_t<128> sum = lazy(a) + a;
+        CHECK_EQ(sum[0], ~size_t(1));
+        CHECK_EQ(sum[1], 1);
+
+        // a partial last word is cut at the end
+        const uint_t<100> b{~size_t(0)};
+        const uint_t<100> wrapped = lazy(uint_t<100>{0}) - b;
+        CHECK((wrapped == uint_t<100>{0} - b));
+    }
+}
+} // namespace understanding_crypto
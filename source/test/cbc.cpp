@@ -0,0 +1,126 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/cbc.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace understanding_crypto::aes {
+
+namespace {
+std::array<uint8_t, 16> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                               0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+const std::array<uint8_t, 16> iv = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+const std::array<uint8_t, 64> plain = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+// NIST SP 800-38A F.2.1
+const std::array<uint8_t, 64> cipher = {
+    0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+    0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+    0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+    0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7};
+
+std::vector<uint8_t> message(size_t size, uint8_t seed) {
+    std::vector<uint8_t> bytes(size);
+    for (auto i = 0U; i < bytes.size(); ++i) {
+        bytes[i] = i * 31 + seed;
+    }
+    return bytes;
+}
+
+// the mode references the expanded keys, a temporary would dangle
+using expanded_t = decltype(AES::Common::expand_key(std::declval<key128_t>()));
+static_assert(!std::is_constructible_v<CBC<expanded_t>, expanded_t, std::span<const uint8_t, 16>>);
+static_assert(std::is_constructible_v<CBC<expanded_t>, const expanded_t &, std::span<const uint8_t, 16>>);
+} // namespace
+
+TEST_SUITE("examples") {
+    TEST_CASE("encrypt") {
+        const auto expanded = AES::Common::expand_key(key128_t{key});
+        std::array<uint8_t, 64> actual;
+        CBC{expanded, iv}.encrypt(plain, actual);
+        CHECK_EQ(actual, cipher);
+
+        // the chain carries over between calls
+        CBC cbc{expanded, iv};
+        cbc.encrypt(std::span(plain).first(16), actual);
+        cbc.encrypt(std::span(plain).subspan(16), std::span(actual).subspan(16));
+        CHECK_EQ(actual, cipher);
+    }
+
+    TEST_CASE("decrypt") {
+        const auto schedule = AES::Common::expand_key_schedule(key128_t{key});
+        auto actual = cipher;
+        CBC cbc{schedule, iv};
+        cbc.decrypt(std::span(actual).first(32), std::span(actual).first(32));
+        cbc.decrypt(std::span(actual).subspan(32), std::span(actual).subspan(32));
+        CHECK_EQ(actual, plain);
+    }
+}
+
+TEST_SUITE("bulk") {
+    TEST_CASE("decrypt spans several batches") {
+        const auto schedule = AES::Common::expand_key_schedule(key128_t{key});
+        const auto message_plain = message(16 * 150, 7);
+        std::vector<uint8_t> encrypted(message_plain.size());
+        CBC{schedule, iv}.encrypt(message_plain, encrypted);
+
+        std::vector<uint8_t> decrypted(encrypted.size());
+        CBC{schedule, iv}.decrypt(encrypted, decrypted);
+        CHECK(decrypted == message_plain);
+        CBC{schedule, iv}.decrypt(encrypted, encrypted);
+        CHECK(encrypted == message_plain);
+    }
+
+    TEST_CASE("streams match one by one") {
+        const auto schedule = AES::Common::expand_key_schedule(key128_t{key});
+        using CBC_t = CBC<key_schedule_t<11>>;
+        // more streams than one group, of different lengths, one of them empty
+        constexpr size_t count = 19;
+        std::vector<std::vector<uint8_t>> inputs, outputs;
+        std::vector<std::array<uint8_t, 16>> chains(count, iv);
+        std::vector<CBC_t::stream_t> streams;
+        for (auto i = 0U; i < count; ++i) {
+            inputs.push_back(message(16 * (i * 7 % 23), i));
+            chains[i][0] ^= i;
+        }
+        outputs.resize(count);
+        for (auto i = 0U; i < count; ++i) {
+            outputs[i].resize(inputs[i].size());
+            streams.push_back({chains[i], inputs[i], outputs[i]});
+        }
+        const auto ivs = chains;
+        CBC_t::encrypt_streams(schedule, streams);
+
+        for (auto i = 0U; i < count; ++i) {
+            std::vector<uint8_t> expected(inputs[i].size());
+            CBC{schedule, ivs[i]}.encrypt(inputs[i], expected);
+            CHECK(outputs[i] == expected);
+            const auto last = expected.empty() ? std::span<const uint8_t>(ivs[i])
+                                               : std::span<const uint8_t>(expected).last(16);
+            CHECK(std::equal(last.begin(), last.end(), chains[i].begin()));
+        }
+    }
+
+    TEST_CASE("partial blocks are rejected") {
+        const auto schedule = AES::Common::expand_key_schedule(key128_t{key});
+        const auto data = message(16 * 3 + 5, 1);
+        std::vector<uint8_t> output(data.size());
+        CBC cbc{schedule, iv};
+        CHECK_THROWS_AS(cbc.encrypt(data, output), std::invalid_argument);
+        CHECK_THROWS_AS(cbc.decrypt(data, output), std::invalid_argument);
+
+        using CBC_t = CBC<key_schedule_t<11>>;
+        std::array<uint8_t, 16> first_chain = iv, second_chain = iv;
+        const auto whole = std::span(data).first(32);
+        const std::array<CBC_t::stream_t, 2> streams = {{{first_chain, whole, output},
+                                                         {second_chain, data, output}}};
+        CHECK_THROWS_AS(CBC_t::encrypt_streams(schedule, streams), std::invalid_argument);
+        CHECK(first_chain == iv);
+    }
+}
+} // namespace understanding_crypto::aes
@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/context.hpp>
+
+#include <thread>
+#include <vector>
+
+namespace understanding_crypto::aes {
+
+namespace {
+std::array<uint8_t, 16> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                               0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+std::array<uint8_t, 32> numbered_key(uint32_t number) {
+    std::array<uint8_t, 32> bytes{};
+    std::memcpy(bytes.data(), &number, sizeof(number));
+    return bytes;
+}
+} // namespace
+
+TEST_SUITE("context") {
+    // FIPS-197 appendix B
+    TEST_CASE("encrypt and decrypt") {
+        const Context context{key128_t{key}};
+        std::array<uint8_t, 16> block = {0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d,
+                                         0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34};
+        const auto plain = block;
+        const std::array<uint8_t, 16> expected = {0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb,
+                                                  0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32};
+        context.encrypt(block);
+        CHECK_EQ(block, expected);
+        context.decrypt(block);
+        CHECK_EQ(block, plain);
+        CHECK_EQ(reinterpret_cast<uintptr_t>(&context.keys()) % 64, 0);
+    }
+
+    TEST_CASE("matches its key") {
+        auto other = numbered_key(1);
+        const Context context{key256_t{other}};
+        CHECK(context.matches(key256_t{other}));
+        other[31] ^= 1;
+        CHECK_FALSE(context.matches(key256_t{other}));
+    }
+}
+
+TEST_SUITE("key cache") {
+    TEST_CASE("hits after the first use") {
+        Key_Cache<key256_t> cache{8, 2};
+        auto first = numbered_key(1);
+        const auto context = cache.get(key256_t{first});
+        CHECK_EQ(cache.get(key256_t{first}), context);
+        CHECK_EQ(cache.hits(), 1);
+        CHECK_EQ(cache.misses(), 1);
+        CHECK(context->matches(key256_t{first}));
+    }
+
+    TEST_CASE("evicts the least recently used") {
+        Key_Cache<key256_t> cache{4, 1};
+        std::vector<std::array<uint8_t, 32>> keys;
+        for (auto i = 0U; i < 5; ++i) {
+            keys.push_back(numbered_key(i));
+        }
+        for (auto i = 0U; i < 4; ++i) {
+            cache.get(key256_t{keys[i]});
+        }
+        // key 0 becomes the most recent, key 1 is evicted by key 4
+        cache.get(key256_t{keys[0]});
+        const auto held = cache.get(key256_t{keys[4]});
+        CHECK_EQ(cache.size(), 4);
+        CHECK_EQ(cache.hits(), 1);
+
+        cache.get(key256_t{keys[0]});
+        CHECK_EQ(cache.hits(), 2);
+        cache.get(key256_t{keys[1]});
+        CHECK_EQ(cache.misses(), 6);
+        // a context that was handed out stays valid after eviction
+        CHECK(held->matches(key256_t{keys[4]}));
+    }
+
+    TEST_CASE("shared between threads") {
+        Key_Cache<key256_t> cache{64};
+        std::atomic<int> mismatches = 0;
+        std::vector<std::thread> threads;
+        for (auto t = 0U; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (auto i = 0U; i < 1000; ++i) {
+                    auto bytes = numbered_key(i % 32);
+                    mismatches += !cache.get(key256_t{bytes})->matches(key256_t{bytes});
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(cache.hits() + cache.misses(), 4000);
+        CHECK_LE(cache.size(), 64);
+    }
+}
+
+TEST_SUITE("secure zero") {
+    TEST_CASE("clears every byte") {
+        std::array<uint8_t, 37> bytes;
+        bytes.fill(0xa5);
+        secure_zero(bytes.data(), bytes.size());
+        CHECK_EQ(bytes, std::array<uint8_t, 37>{});
+    }
+}
+} // namespace understanding_crypto::aes
@@ -0,0 +1,102 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/ctr.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace understanding_crypto::aes {
+
+namespace {
+std::array<uint8_t, 16> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                               0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+const std::array<uint8_t, 16> initial_counter = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                                 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+
+// the mode references the expanded keys, a temporary would dangle
+using expanded_t = decltype(AES::Common::expand_key(std::declval<key128_t>()));
+static_assert(!std::is_constructible_v<CTR<expanded_t>, expanded_t, std::span<const uint8_t, 16>>);
+static_assert(std::is_constructible_v<CTR<expanded_t>, const expanded_t &, std::span<const uint8_t, 16>>);
+} // namespace
+
+TEST_SUITE("examples") {
+    // NIST SP 800-38A F.5.1
+    TEST_CASE("encrypt") {
+        const auto expanded = AES::Common::expand_key(key128_t{key});
+        const std::array<uint8_t, 64> plain = {
+            0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+            0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+            0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+            0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+        const std::array<uint8_t, 64> expected = {
+            0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+            0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+            0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+            0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee};
+
+        std::array<uint8_t, 64> cipher;
+        CTR ctr{expanded, initial_counter};
+        ctr.process(plain, cipher);
+        CHECK_EQ(cipher, expected);
+        CHECK_EQ(ctr.tell(), 64);
+
+        ctr.seek(0);
+        ctr.process(cipher, cipher);
+        CHECK_EQ(cipher, plain);
+    }
+}
+
+TEST_SUITE("counter") {
+    TEST_CASE("wraps around") {
+        const auto expanded = AES::Common::expand_key(key128_t{key});
+        std::array<uint8_t, 16> all_ones;
+        all_ones.fill(0xff);
+        CTR ctr{expanded, all_ones};
+
+        std::array<uint8_t, 32> blocks;
+        ctr.counter_blocks(0, blocks);
+        CHECK_EQ(AES::Common::load_block(block128_t{&blocks[0], 16}), state_t{~0U, ~0U, ~0U, ~0U});
+        CHECK_EQ(AES::Common::load_block(block128_t{&blocks[16], 16}), state_t{0, 0, 0, 0});
+        ctr.counter_blocks(2, blocks);
+        CHECK_EQ(AES::Common::load_block(block128_t{&blocks[0], 16}), state_t{0, 0, 0, 1});
+    }
+
+    TEST_CASE("low word carries into high word") {
+        const auto expanded = AES::Common::expand_key(key128_t{key});
+        CTR ctr{expanded, initial_counter};
+
+        std::array<uint8_t, 16> block;
+        ctr.counter_blocks(0x0706050403020101ULL, block);
+        CHECK_EQ(AES::Common::load_block(block), state_t{0xf0f1f2f3, 0xf4f5f6f8, 0, 0});
+    }
+}
+
+TEST_SUITE("random access") {
+    TEST_CASE("seek matches streaming") {
+        const auto expanded = AES::Common::expand_key(key128_t{key});
+        // several keystream batches and an unaligned length
+        std::vector<uint8_t> plain(5 * CTR<decltype(expanded)>::batch_blocks * 16 + 7);
+        for (auto i = 0U; i < plain.size(); ++i) {
+            plain[i] = i * 7;
+        }
+        std::vector<uint8_t> cipher(plain.size());
+        CTR ctr{expanded, initial_counter};
+        ctr.process(plain, cipher);
+
+        // pieces of odd length and at odd offsets
+        std::vector<uint8_t> pieces(plain.size());
+        size_t length = 1;
+        for (size_t offset = 0; offset < plain.size(); offset += length, length = length * 3 + 1) {
+            length = std::min(length, plain.size() - offset);
+            ctr.seek(offset);
+            ctr.process(std::span(cipher).subspan(offset, length), std::span(pieces).subspan(offset, length));
+        }
+        CHECK_EQ(pieces, plain);
+
+        std::array<uint8_t, 5> range;
+        ctr.seek(1003);
+        ctr.process(std::span(cipher).subspan(1003, range.size()), range);
+        CHECK(std::equal(range.begin(), range.end(), plain.begin() + 1003));
+    }
+}
+} // namespace understanding_crypto::aes
@@ -0,0 +1,112 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/drbg.hpp>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace understanding_crypto::aes {
+
+namespace {
+template <size_t SIZE> std::array<uint8_t, SIZE> counting(uint8_t first) {
+    std::array<uint8_t, SIZE> bytes;
+    for (auto i = 0U; i < SIZE; ++i) {
+        bytes[i] = first + i;
+    }
+    return bytes;
+}
+} // namespace
+
+TEST_SUITE("ctr drbg") {
+    // computed with an independent implementation of SP 800-90A 10.2.1 on top of OpenSSL AES-256-ECB
+    TEST_CASE("known answer") {
+        const auto entropy = counting<48>(0x00);
+        const auto personalization = counting<20>(0x80);
+        CTR_DRBG drbg{entropy, personalization};
+
+        std::array<uint8_t, 64> first;
+        drbg.generate(first);
+        const std::array<uint8_t, 64> expected_first = {
+            0xd9, 0x63, 0x80, 0x00, 0xf8, 0xa4, 0x82, 0x50, 0x7d, 0x7d, 0xb0, 0x2c, 0x96, 0xab, 0x92, 0xb9,
+            0xff, 0x91, 0xfa, 0x64, 0x45, 0x3f, 0x77, 0xa2, 0x2b, 0x2a, 0x22, 0x7f, 0xd9, 0xd4, 0xb0, 0x0f,
+            0x3f, 0x63, 0x3f, 0x9b, 0x0d, 0x5d, 0x5b, 0x20, 0x56, 0xfe, 0x85, 0x3f, 0x3a, 0x21, 0x25, 0x57,
+            0xd5, 0xd8, 0x0f, 0x8c, 0xa8, 0x04, 0xb1, 0xca, 0x21, 0x90, 0xaf, 0x8f, 0xf2, 0xaa, 0x47, 0xaf};
+        CHECK_EQ(first, expected_first);
+
+        // partial last block and additional input
+        std::array<uint8_t, 37> second;
+        drbg.generate(second, counting<16>(0x40));
+        const std::array<uint8_t, 37> expected_second = {
+            0x4e, 0x8a, 0x65, 0xfb, 0xe9, 0x09, 0xf9, 0x15, 0xd5, 0x07, 0xb6, 0xed, 0xae, 0x95, 0x26, 0x01,
+            0xe0, 0x44, 0x35, 0x1f, 0xba, 0x31, 0xb2, 0x62, 0x19, 0x0a, 0xd7, 0x27, 0xc7, 0x83, 0x0d, 0xd2,
+            0xf3, 0xe2, 0xf5, 0x45, 0x09};
+        CHECK_EQ(second, expected_second);
+
+        drbg.reseed(counting<48>(0xc0), std::array<uint8_t, 2>{0x01, 0x02});
+        std::array<uint8_t, 32> third;
+        drbg.generate(third);
+        const std::array<uint8_t, 32> expected_third = {
+            0x70, 0xfb, 0xc7, 0x04, 0xa4, 0x1a, 0x91, 0x37, 0x42, 0xfd, 0x61, 0x1f, 0x6a, 0xb2, 0xa1, 0xd4,
+            0xbe, 0x5e, 0x4e, 0x79, 0x89, 0x24, 0xca, 0x61, 0x19, 0x3f, 0x8f, 0xe6, 0xcc, 0x34, 0xd9, 0xad};
+        CHECK_EQ(third, expected_third);
+    }
+}
+
+TEST_SUITE("thread random") {
+    TEST_CASE("requests of every size") {
+        std::set<std::vector<uint8_t>> seen;
+        for (const auto size : {1U, 15U, 16U, 100U, 4096U, 5000U, 3 * 4096U + 7}) {
+            std::vector<uint8_t> bytes(size);
+            Thread_Random::fill(bytes);
+            CHECK(seen.insert(bytes).second);
+        }
+        // a large request has no run of zeros a cleared buffer would leave
+        std::vector<uint8_t> large(1 << 17);
+        Thread_Random::fill(large);
+        CHECK_LT(std::count(large.begin(), large.end(), 0), large.size() / 128);
+    }
+
+    TEST_CASE("threads do not share output") {
+        std::array<std::array<uint8_t, 32>, 4> outputs;
+        std::vector<std::thread> threads;
+        for (auto i = 0U; i < outputs.size(); ++i) {
+            threads.emplace_back([&outputs, i] { Thread_Random::fill(outputs[i]); });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        const std::set<std::array<uint8_t, 32>> distinct(outputs.begin(), outputs.end());
+        CHECK_EQ(distinct.size(), outputs.size());
+    }
+
+    TEST_CASE("parent and child differ after fork") {
+        // leaves output buffered in the parent, the child must not hand out the same bytes
+        std::array<uint8_t, 16> warm_up;
+        Thread_Random::fill(warm_up);
+
+        int pipe_ends[2];
+        REQUIRE_EQ(pipe(pipe_ends), 0);
+        const auto child = fork();
+        REQUIRE(child >= 0);
+        if (child == 0) {
+            std::array<uint8_t, 32> bytes;
+            Thread_Random::fill(bytes);
+            const auto written = write(pipe_ends[1], bytes.data(), bytes.size());
+            _exit(written == ssize_t(bytes.size()) ? 0 : 1);
+        }
+
+        std::array<uint8_t, 32> parent;
+        Thread_Random::fill(parent);
+        std::array<uint8_t, 32> from_child{};
+        CHECK_EQ(read(pipe_ends[0], from_child.data(), from_child.size()), ssize_t(from_child.size()));
+        int status;
+        waitpid(child, &status, 0);
+        close(pipe_ends[0]);
+        close(pipe_ends[1]);
+        CHECK_NE(parent, from_child);
+    }
+}
+} // namespace understanding_crypto::aes
@@ -0,0 +1,101 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/dynamic_uint.hpp>
+
+#include <random>
+#include <stdexcept>
+
+namespace understanding_crypto {
+using namespace test;
+
+TEST_SUITE("dynamic_uint") {
+    TEST_CASE("arithmetic against uint_t") {
+        std::mt19937_64 random(21);
+        Limb_Arena::Scope scope;
+        for (auto i = 0; i < 200; ++i) {
+            const auto a = random_operand<512>(random);
+            const auto b = random_operand<320>(random);
+            const Dynamic_Uint x(a), y(b);
+            CHECK(x.to_uint<512>() == a);
+
+            auto sum = x;
+            sum += y;
+            CHECK(sum.to_uint<512>() == uint_t<512>(a + b));
+            auto difference = x;
+            difference -= y;
+            CHECK(difference.to_uint<512>() == uint_t<512>(a - b));
+
+            CHECK((x * y).to_uint<832>() == uint_t<832>::from_multiplication_of(a, b));
+            CHECK((x * x).to_uint<1024>() == uint_t<1024>::from_square_of(a));
+            if (b != uint_t<320>{0}) {
+                CHECK((x / y).to_uint<512>() == a / b);
+                CHECK((x % y).to_uint<320>() == a % b);
+            }
+
+            const auto shift = size_t(random() % 600);
+            auto left = x, right = x;
+            left <<= shift;
+            right >>= shift;
+            CHECK(left.to_uint<512>() == uint_t<512>(a << shift));
+            CHECK(right.to_uint<512>() == uint_t<512>(a >> shift));
+
+            CHECK((x < y) == (a < b));
+            CHECK((x == y) == (a == b));
+            CHECK(x == Dynamic_Uint(uint_t<1024>(a)));
+        }
+
+        const Dynamic_Uint x(uint_t<512>{7}), zero(uint_t<320>{0});
+        CHECK_THROWS_AS(x / zero, std::domain_error);
+        CHECK_THROWS_AS(x % zero, std::domain_error);
+    }
+
+    TEST_CASE("modular exponentiation against uint_t") {
+        std::mt19937_64 random(2048);
+        Limb_Arena::Scope scope;
+        for (auto i = 0; i < 4; ++i) {
+            auto n = random_operand<1024>(random);
+            n[0] |= 1;
+            const auto base = random_operand<1024>(random) % n;
+            const auto exponent = random_operand<1024>(random);
+
+            const Dynamic_Montgomery context{Dynamic_Uint(n)};
+            CHECK(context.word_count() == n.word_count);
+            const auto result = pow_mod(context, Dynamic_Uint(base), Dynamic_Uint(exponent));
+            CHECK(result.to_uint<1024>() == pow_mod(base, exponent, n));
+        }
+
+        // the modulus width follows its value, not the width it is stored in
+        const auto n = Dynamic_Uint(uint_t<256>{1000003});
+        const Dynamic_Montgomery context{n};
+        CHECK(context.word_count() == 1);
+        CHECK(pow_mod(context, Dynamic_Uint(uint_t<64>{2}), Dynamic_Uint(uint_t<64>{1000002}))[0] == 1);
+    }
+
+    TEST_CASE("the arena does not grow once it is warm") {
+        std::mt19937_64 random(7);
+        Limb_Arena arena;
+        auto n = random_operand<2048>(random);
+        n[0] |= 1;
+        const auto exponent = random_operand<2048>(random);
+        const auto run = [&] {
+            Limb_Arena::Scope scope(arena);
+            const Dynamic_Montgomery context{Dynamic_Uint(n, arena)};
+            return pow_mod(context, Dynamic_Uint(uint_t<64>{3}, arena), Dynamic_Uint(exponent, arena))
+                .to_uint<2048>();
+        };
+        const auto expected = run();
+        const auto capacity = arena.capacity();
+        CHECK(capacity > 0);
+        for (auto i = 0; i < 3; ++i) {
+            CHECK(run() == expected);
+            CHECK(arena.capacity() == capacity);
+        }
+
+        // requests larger than a chunk get a chunk of their own
+        Limb_Arena::Scope scope(arena);
+        CHECK(arena.allocate(3 * Limb_Arena::chunk_words).size() == 3 * Limb_Arena::chunk_words);
+        CHECK(arena.capacity() >= capacity + 3 * Limb_Arena::chunk_words);
+    }
+}
+} // namespace understanding_crypto
@@ -0,0 +1,97 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/gcd.hpp>
+
+#include <numeric>
+#include <random>
+
+namespace understanding_crypto {
+using namespace test;
+
+namespace {
+template <size_t BITS>
+bool is_inverse(const uint_t<BITS> &x, const uint_t<BITS> &inverse, const uint_t<BITS> &n) {
+    return uint_t<BITS>(uint_t<2 * BITS>::from_multiplication_of(x, inverse) % n) == uint_t<BITS>{1};
+}
+
+template <size_t BITS> void check_random_inverses(uint64_t seed, size_t count) {
+    std::mt19937_64 random(seed);
+    for (size_t i = 0; i < count; ++i) {
+        auto n = random_operand<BITS>(random);
+        n[0] |= 1;
+        const auto x = random_operand<BITS>(random) % n;
+        const auto inverse = inverse_mod(x, n);
+        const auto expected = inverse_mod_public(x, n);
+        REQUIRE(inverse.has_value() == expected.has_value());
+        if (inverse) {
+            CHECK(*inverse == *expected);
+            CHECK(*inverse < n);
+            CHECK(is_inverse(x, *inverse, n));
+        } else {
+            CHECK(gcd(x, n) != uint_t<BITS>{1});
+        }
+    }
+}
+} // namespace
+
+TEST_SUITE("gcd") {
+    TEST_CASE("gcd against std::gcd") {
+        std::mt19937_64 random(23);
+        for (auto i = 0; i < 1000; ++i) {
+            const uint64_t a = random() >> (random() % 64), b = random() >> (random() % 64);
+            CHECK_EQ(gcd(uint_t<64>{a}, uint_t<64>{b})[0], std::gcd(a, b));
+        }
+        CHECK(gcd(uint_t<64>{0}, uint_t<64>{0}) == uint_t<64>{0});
+        const auto common = random_operand<256>(random);
+        const auto a = uint_t<512>::from_multiplication_of(common, uint_t<64>{6});
+        const auto b = uint_t<512>::from_multiplication_of(common, uint_t<64>{35});
+        CHECK(gcd(a, b) == uint_t<512>(common));
+    }
+
+    TEST_CASE("constant time inverse against the variable time one") {
+        check_random_inverses<64>(1, 500);
+        check_random_inverses<255>(2, 200);
+        check_random_inverses<256>(3, 200);
+        check_random_inverses<1024>(4, 50);
+        check_random_inverses<2048>(5, 10);
+    }
+
+    TEST_CASE("curve25519 field") {
+        uint_t<255> p{0};
+        p = p - 19;
+        // 2^-1 = (p + 1) / 2
+        CHECK(*inverse_mod(uint_t<255>{2}, p) == uint_t<255>((p >> 1U) + 1));
+        CHECK(*inverse_mod(p - 1, p) == p - 1);
+        CHECK(*inverse_mod(uint_t<255>{1}, p) == uint_t<255>{1});
+    }
+
+    TEST_CASE("no inverse") {
+        CHECK_FALSE(inverse_mod(uint_t<64>{0}, uint_t<64>{97}).has_value());
+        CHECK_FALSE(inverse_mod(uint_t<64>{6}, uint_t<64>{15}).has_value());
+        CHECK_FALSE(inverse_mod_public(uint_t<64>{6}, uint_t<64>{15}).has_value());
+        CHECK_FALSE(inverse_mod_public(uint_t<64>{6}, uint_t<64>{16}).has_value());
+        CHECK_FALSE(inverse_mod_public(uint_t<64>{3}, uint_t<64>{0}).has_value());
+    }
+
+    TEST_CASE("even modulus") {
+        // d = e^-1 mod lambda for RSA with e = 65537
+        std::mt19937_64 random(65537);
+        for (auto i = 0; i < 50; ++i) {
+            auto lambda = random_operand<1024>(random);
+            lambda[0] &= ~size_t(1);
+            const uint_t<1024> e{65537U};
+            const auto d = inverse_mod_public(e, lambda);
+            if (d) {
+                CHECK(is_inverse(e, *d, lambda));
+            } else {
+                CHECK(gcd(e, lambda) != uint_t<1024>{1});
+            }
+        }
+        CHECK(*inverse_mod_public(uint_t<64>{3}, uint_t<64>{16}) == uint_t<64>{11});
+        CHECK(*inverse_mod_public(uint_t<64>{17}, uint_t<64>{16}) == uint_t<64>{1});
+        // x above n is reduced first
+        CHECK(*inverse_mod_public(uint_t<64>{100}, uint_t<64>{97}) == uint_t<64>{65});
+    }
+}
+} // namespace understanding_crypto
@@ -0,0 +1,203 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/gcm.hpp>
+
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace understanding_crypto::aes {
+
+namespace {
+std::vector<uint8_t> from_hex(std::string_view hex) {
+    std::vector<uint8_t> bytes(hex.size() / 2);
+    for (auto i = 0U; i < bytes.size(); ++i) {
+        const auto nibble = [](char c) { return c <= '9' ? c - '0' : c - 'a' + 10; };
+        bytes[i] = (nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]);
+    }
+    return bytes;
+}
+
+// encrypts, checks the tag, decrypts again and checks that a modified tag is rejected
+template <typename key_t>
+void check_vector(std::string_view key, std::string_view iv, std::string_view aad, std::string_view plain,
+                  std::string_view cipher, std::string_view tag) {
+    auto key_bytes = from_hex(key);
+    const auto expanded = AES::Common::expand_key(key_t{key_bytes.data(), key_t::extent});
+    const GCM gcm{expanded};
+    const auto iv_bytes = from_hex(iv);
+    const auto aad_bytes = from_hex(aad);
+    const auto plain_bytes = from_hex(plain);
+
+    std::vector<uint8_t> actual(plain_bytes.size());
+    std::array<uint8_t, 16> actual_tag;
+    gcm.encrypt(iv_bytes, aad_bytes, plain_bytes, actual, actual_tag);
+    CHECK_EQ(actual, from_hex(cipher));
+    CHECK_EQ(std::vector(actual_tag.begin(), actual_tag.end()), from_hex(tag));
+
+    std::vector<uint8_t> decrypted(actual.size());
+    CHECK(gcm.decrypt(iv_bytes, aad_bytes, actual, decrypted, actual_tag));
+    CHECK_EQ(decrypted, plain_bytes);
+
+    actual_tag[15] ^= 1;
+    CHECK_FALSE(gcm.decrypt(iv_bytes, aad_bytes, actual, decrypted, actual_tag));
+    CHECK(std::all_of(decrypted.begin(), decrypted.end(), [](auto byte) { return byte == 0; }));
+}
+
+constexpr std::string_view key_3 = "feffe9928665731c6d6a8f9467308308";
+constexpr std::string_view plain_3 = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                                     "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255";
+constexpr std::string_view plain_4 = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                                     "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+constexpr std::string_view aad_4 = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+
+// the mode references the expanded keys, a temporary would dangle
+using expanded_t = decltype(AES::Common::expand_key(std::declval<key128_t>()));
+static_assert(!std::is_constructible_v<GCM<expanded_t>, expanded_t>);
+static_assert(std::is_constructible_v<GCM<expanded_t>, const expanded_t &>);
+} // namespace
+
+// test cases of the GCM specification submitted to NIST (McGrew, Viega)
+TEST_SUITE("examples") {
+    TEST_CASE("test case 1") {
+        check_vector<key128_t>("00000000000000000000000000000000", "000000000000000000000000", "", "", "",
+                               "58e2fccefa7e3061367f1d57a4e7455a");
+    }
+    TEST_CASE("test case 2") {
+        check_vector<key128_t>("00000000000000000000000000000000", "000000000000000000000000", "",
+                               "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78",
+                               "ab6e47d42cec13bdf53a67b21257bddf");
+    }
+    TEST_CASE("test case 3") {
+        check_vector<key128_t>(key_3, "cafebabefacedbaddecaf888", "", plain_3,
+                               "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+                               "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+                               "4d5c2af327cd64a62cf35abd2ba6fab4");
+    }
+    TEST_CASE("test case 4") {
+        check_vector<key128_t>(key_3, "cafebabefacedbaddecaf888", aad_4, plain_4,
+                               "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+                               "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+                               "5bc94fbc3221a5db94fae95ae7121a47");
+    }
+    TEST_CASE("test case 5") {
+        check_vector<key128_t>(key_3, "cafebabefacedbad", aad_4, plain_4,
+                               "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c7423"
+                               "73806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+                               "3612d2e79e3b0785561be14aaca2fccb");
+    }
+    TEST_CASE("test case 6") {
+        check_vector<key128_t>(key_3,
+                               "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+                               "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b",
+                               aad_4, plain_4,
+                               "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca7"
+                               "01e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+                               "619cc5aefffe0bfa462af43c1699d050");
+    }
+    TEST_CASE("test case 14") {
+        check_vector<key256_t>("0000000000000000000000000000000000000000000000000000000000000000",
+                               "000000000000000000000000", "", "00000000000000000000000000000000",
+                               "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919");
+    }
+    TEST_CASE("test case 16") {
+        check_vector<key256_t>("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308",
+                               "cafebabefacedbaddecaf888", aad_4, plain_4,
+                               "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+                               "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+                               "76fc6ece0f4e1768cddf8853bb2d551b");
+    }
+}
+
+TEST_SUITE("ghash") {
+    // x * H one bit at a time, straight from the specification
+    GHASH::element_t multiply_bitwise(GHASH::element_t x, GHASH::element_t h) {
+        GHASH::element_t z{};
+        for (auto i = 0U; i < 128; ++i) {
+            const auto bit = i < 64 ? (x.high >> (63 - i)) & 1 : (x.low >> (127 - i)) & 1;
+            if (bit) {
+                z ^= h;
+            }
+            h = GHASH::multiply_x(h);
+        }
+        return z;
+    }
+
+    TEST_CASE("table multiplication") {
+        const GHASH::element_t h{0x66e94bd4ef8a2c3bULL, 0x884cfa59ca342b2eULL};
+        const GHASH ghash{h};
+        GHASH::element_t x{0x0388dace60b6a392ULL, 0xf328c2b971b2fe78ULL};
+        for (auto i = 0U; i < 16; ++i) {
+            CHECK_EQ(ghash.multiply(x), multiply_bitwise(x, h));
+            x = multiply_bitwise(x, x);
+        }
+        CHECK_EQ(ghash.power(3), multiply_bitwise(multiply_bitwise(h, h), multiply_bitwise(h, h)));
+    }
+
+    TEST_CASE("aggregated blocks match single blocks") {
+        const GHASH ghash{GHASH::element_t{0x66e94bd4ef8a2c3bULL, 0x884cfa59ca342b2eULL}};
+        // several aggregated groups, single blocks and a partial block
+        std::vector<uint8_t> data(3 * GHASH::aggregated_blocks * GHASH::block_size + 3 * 16 + 5);
+        for (auto i = 0U; i < data.size(); ++i) {
+            data[i] = i * 13 + 1;
+        }
+
+        GHASH::element_t expected{};
+        for (auto offset = 0U; offset < data.size(); offset += 16) {
+            std::array<uint8_t, 16> block{};
+            std::copy_n(data.begin() + offset, std::min<size_t>(16, data.size() - offset), block.begin());
+            expected ^= GHASH::load(block);
+            expected = ghash.multiply(expected);
+        }
+        GHASH::element_t actual{};
+        ghash.absorb(actual, data);
+        CHECK_EQ(actual, expected);
+    }
+}
+
+TEST_SUITE("long messages") {
+    TEST_CASE("fused pass matches block by block") {
+        std::array<uint8_t, 16> key{};
+        const auto expanded = AES::Common::expand_key(key128_t{key});
+        const GCM gcm{expanded};
+        const std::array<uint8_t, 12> iv = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+
+        std::vector<uint8_t> plain(1000);
+        for (auto i = 0U; i < plain.size(); ++i) {
+            plain[i] = i;
+        }
+        std::vector<uint8_t> cipher(plain.size());
+        std::array<uint8_t, 16> tag;
+        gcm.encrypt(iv, {}, plain, cipher, tag);
+
+        // counter mode starting at inc32(J0) and GHASH over the ciphertext
+        const auto j0 = gcm.initial_counter(iv);
+        auto counter = j0;
+        counter[15] += 1;
+        std::vector<uint8_t> expected(plain.size());
+        CTR ctr{expanded, counter};
+        ctr.process(plain, expected);
+        CHECK_EQ(cipher, expected);
+
+        GHASH::element_t y{};
+        for (auto offset = 0U; offset < cipher.size(); offset += 16) {
+            std::array<uint8_t, 16> block{};
+            std::copy_n(cipher.begin() + offset, std::min<size_t>(16, cipher.size() - offset), block.begin());
+            y ^= GHASH::load(block);
+            y = gcm.hash().multiply(y);
+        }
+        y ^= GHASH::element_t{0, cipher.size() * 8};
+        y = gcm.hash().multiply(y);
+        std::array<uint8_t, 16> mask{};
+        CTR{expanded, j0}.process(mask, mask);
+        y ^= GHASH::load(mask);
+        std::array<uint8_t, 16> expected_tag;
+        GHASH::store(y, expected_tag);
+        CHECK_EQ(tag, expected_tag);
+
+        std::vector<uint8_t> decrypted(cipher.size());
+        CHECK(gcm.decrypt(iv, {}, cipher, decrypted, tag));
+        CHECK_EQ(decrypted, plain);
+    }
+}
+} // namespace understanding_crypto::aes
@@ -0,0 +1,82 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/modexp.hpp>
+
+#include <random>
+#include <string_view>
+
+namespace understanding_crypto {
+using namespace test;
+
+namespace {
+uint64_t reference_pow_mod(uint64_t base, uint64_t exponent, uint64_t n) {
+    uint_t<64>::double_value_t result = 1 % n, power = base % n;
+    for (; exponent != 0; exponent >>= 1) {
+        if (exponent & 1) {
+            result = result * power % n;
+        }
+        power = power * power % n;
+    }
+    return uint64_t(result);
+}
+} // namespace
+
+TEST_SUITE("modexp") {
+    TEST_CASE("single word against square and multiply") {
+        std::mt19937_64 random(19);
+        for (auto i = 0; i < 500; ++i) {
+            const uint64_t n = random() | 1;
+            const uint64_t base = random();
+            // short exponents take the binary path of pow_mod_public
+            const uint64_t exponent = i % 2 == 0 ? random() : random() >> (random() % 64);
+            const auto expected = reference_pow_mod(base, exponent, n);
+            CHECK_EQ(pow_mod(uint_t<64>{base}, uint_t<64>{exponent}, uint_t<64>{n})[0], expected);
+            CHECK_EQ(pow_mod_public(uint_t<64>{base}, uint_t<64>{exponent}, uint_t<64>{n})[0], expected);
+        }
+    }
+
+    TEST_CASE("zero exponent") {
+        const uint_t<128> n{1000003U};
+        CHECK((pow_mod(uint_t<128>{5U}, uint_t<128>{0U}, n) == uint_t<128>{1U}));
+        CHECK((pow_mod_public(uint_t<128>{5U}, uint_t<128>{0U}, n) == uint_t<128>{1U}));
+    }
+
+    TEST_CASE("fermat on the curve25519 prime") {
+        const auto p = from_hex<256>("7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed");
+        const auto exponent = p - 1;
+        std::mt19937_64 random(25519);
+        for (auto i = 0; i < 8; ++i) {
+            uint_t<256> base{0};
+            for (auto &word : base.internal_main) {
+                word = random();
+            }
+            CHECK((pow_mod(base, exponent, p) == uint_t<256>{1U}));
+            CHECK((pow_mod_public(base, exponent, p) == uint_t<256>{1U}));
+        }
+    }
+
+    TEST_CASE("rsa 1024 round trip") {
+        const auto n = from_hex<1024>("e1ce96cd27a332a5a6ba3e57c662da08b4e541bd74bfeb3e8bb5050957b4d70e"
+                                      "9d7d5add120b06cb2a13dcd304c581b668c4f48cb2724db7cc6e7219f05b4a24"
+                                      "4b39b1c8035d6395a55426efda20030edbef044e61d9d46b703cd795e31c5bb7"
+                                      "dde8b79e8ee062a1a1aad3ccb8ec47bd18fd84ad2f57f0d4079667b79c666bd5");
+        const auto d = from_hex<1024>("64266796084d86aa17dfa4c4f3756674d41e9660bc065f04f79bcae710e2613b"
+                                      "d73800f3ea0bbff09df1ff500c5eb920392999b949700eee451a7b3aebf2e157"
+                                      "8fec03f7275592e95a661548ee4284bbe3ab32c601228e92294bf3903a9df1b8"
+                                      "ac90c00411c2cd87076506ebcec15e64fb25067971b984c76ea13e8b1c681345");
+        const auto m = from_hex<1024>("ab0a7f0fae3409c9024dc595fd242d760e73885fdc251dd9191c2a63765fd8e9"
+                                      "4e10bf07dbf43aea8eda2ba89b2017f29e9c89c45b32d17f43d235773afabe81"
+                                      "bf466bbb5dd4ce1c3080f20df376e3d36d45dd27b72ca873aeb4c55e5f3ab8fc"
+                                      "84da3f98bd98db991b25b3d44c07c4aa1fba4f30fc53fd970cd76a71b6");
+        const auto c = from_hex<1024>("1c97ab30187cfa1a476c9eb28cfa689a6b8a2f204bdc42e0814a5903022ddfb6"
+                                      "1371774d259e2dae52b856980fe580504d513d9ccf2042584c4df5f327cd2594"
+                                      "a2c22eded073dba950db2063c8dc20772a2c1dc6f17f959a597d887b8b7e47fa"
+                                      "636dc12dade5a3961ed6aca93609d74974f6cac82070990114de080dc09fcc4");
+        const Montgomery<1024> context{n};
+        CHECK((pow_mod_public(context, m, uint_t<32>{65537U}) == c));
+        CHECK((pow_mod(context, c, d) == m));
+        CHECK((pow_mod_public(context, c, d) == m));
+    }
+}
+} // namespace understanding_crypto
@@ -0,0 +1,97 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/modexp_batch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace understanding_crypto {
+using namespace test;
+
+namespace {
+template <size_t BITS, size_t EXPONENT_BITS> struct Jobs {
+    explicit Jobs(size_t count, uint64_t seed) : results(count) {
+        std::mt19937_64 random(seed);
+        for (size_t i = 0; i < count; ++i) {
+            auto n = random_operand<BITS>(random);
+            n[0] |= 1;
+            moduli.push_back(n);
+            bases.push_back(random_operand<BITS>(random));
+            exponents.push_back(random_operand<EXPONENT_BITS>(random));
+        }
+    }
+
+    void check() const {
+        for (size_t i = 0; i < results.size(); ++i) {
+            CHECK(results[i] == pow_mod(bases[i], exponents[i], moduli[i]));
+        }
+    }
+
+    std::vector<uint_t<BITS>> bases, moduli, results;
+    std::vector<uint_t<EXPONENT_BITS>> exponents;
+};
+
+template <typename engine, size_t BITS, size_t EXPONENT_BITS> void check_engine(uint64_t seed) {
+    Jobs<BITS, EXPONENT_BITS> jobs(2 * engine::lanes, seed);
+    const auto done = modexp::pow_mod_lanes<engine, BITS, EXPONENT_BITS>(jobs.bases, jobs.exponents,
+                                                                         jobs.moduli, jobs.results);
+    CHECK(done == 2 * engine::lanes);
+    jobs.check();
+}
+} // namespace
+
+TEST_SUITE("modexp_batch") {
+    TEST_CASE("batch against one at a time") {
+        // one full group of the widest engine and a rest
+        Jobs<1024, 1024> jobs(11, 22);
+        pow_mod_batch<1024, 1024>(jobs.bases, jobs.exponents, jobs.moduli, jobs.results);
+        jobs.check();
+    }
+
+    TEST_CASE("spans shorter than the moduli") {
+        Jobs<256, 256> jobs(9, 23);
+        const auto bases = std::span<const uint_t<256>>(jobs.bases);
+        const auto exponents = std::span<const uint_t<256>>(jobs.exponents);
+        const auto moduli = std::span<const uint_t<256>>(jobs.moduli);
+        const auto results = std::span(jobs.results);
+        CHECK_THROWS_AS(pow_mod_batch(bases.first(8), exponents, moduli, results), std::invalid_argument);
+        CHECK_THROWS_AS(pow_mod_batch(bases, exponents.first(8), moduli, results), std::invalid_argument);
+        CHECK_THROWS_AS(pow_mod_batch(bases, exponents, moduli, results.first(8)), std::invalid_argument);
+    }
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+    TEST_CASE("every engine against pow_mod") {
+        // sizes where the limbs do and do not fill the top word, short exponents and a modulus of one limb
+        if (modexp::IFMA512::supported()) {
+            check_engine<modexp::IFMA512, 2048, 2048>(1);
+            check_engine<modexp::IFMA512, 520, 64>(2);
+            check_engine<modexp::IFMA512, 52, 17>(3);
+        }
+        if (modexp::AVX2::supported()) {
+            check_engine<modexp::AVX2, 2048, 2048>(4);
+            check_engine<modexp::AVX2, 520, 64>(5);
+            check_engine<modexp::AVX2, 26, 17>(6);
+        }
+    }
+
+    TEST_CASE("largest operands") {
+        // n = 2^BITS - 1 with base n - 1, every limb at its maximum
+        std::vector<uint_t<1040>> moduli(8, uint_t<1040>{0} - 1), bases(8, uint_t<1040>{0} - 2), results(8);
+        std::vector<uint_t<1040>> exponents(8, uint_t<1040>{0} - 1);
+        if (modexp::IFMA512::supported()) {
+            modexp::pow_mod_lanes<modexp::IFMA512, 1040, 1040>(bases, exponents, moduli, results);
+            for (const auto &result : results) {
+                CHECK(result == bases[0]);
+            }
+        }
+        if (modexp::AVX2::supported()) {
+            modexp::pow_mod_lanes<modexp::AVX2, 1040, 1040>(bases, exponents, moduli, results);
+            for (const auto &result : results) {
+                CHECK(result == bases[0]);
+            }
+        }
+    }
+#endif
+}
+} // namespace understanding_crypto
@@ -0,0 +1,88 @@
+#include "numbers.hpp"
+
+#include <doctest/doctest.h>
+#include <understanding_crypto/montgomery.hpp>
+
+#include <random>
+#include <string_view>
+
+namespace understanding_crypto {
+using namespace test;
+
+namespace {
+template <size_t BITS>
+uint_t<BITS> multiply_modulo(const Montgomery<BITS> &context, const uint_t<BITS> &a, const uint_t<BITS> &b) {
+    return context.from_montgomery(context.mont_mul(context.to_montgomery(a), context.to_montgomery(b)));
+}
+} // namespace
+
+TEST_SUITE("montgomery") {
+    TEST_CASE("word inverse") {
+        static_assert(word_inverse(uint64_t(3)) * 3 == 1);
+        std::mt19937_64 random(17);
+        for (auto i = 0; i < 1000; ++i) {
+            const uint64_t x = random() | 1;
+            CHECK_EQ(word_inverse(x) * x, 1U);
+            CHECK_EQ(uint32_t(word_inverse(uint32_t(x)) * uint32_t(x)), 1U);
+        }
+    }
+
+    TEST_CASE("single word against 128 bit arithmetic") {
+        std::mt19937_64 random(16);
+        for (auto i = 0; i < 1000; ++i) {
+            const uint64_t n = random() | 1;
+            const uint64_t a = random() % n, b = random() % n;
+            const Montgomery<64> context{uint_t<64>{n}};
+            const auto expected = uint64_t(uint_t<64>::double_value_t(a) * b % n);
+            CHECK_EQ(multiply_modulo(context, uint_t<64>{a}, uint_t<64>{b})[0], expected);
+            const auto square = context.mont_sqr(context.to_montgomery(uint_t<64>{a}));
+            CHECK_EQ(context.from_montgomery(square)[0], uint64_t(uint_t<64>::double_value_t(a) * a % n));
+        }
+    }
+
+    TEST_CASE("conversion round trip") {
+        const auto n = from_hex<256>("ffffffff00000001000000000000000000000000ffffffffffffffffffffffff");
+        const Montgomery<256> context{n};
+        const auto a = from_hex<256>("6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296");
+        CHECK(context.from_montgomery(context.to_montgomery(a)) == a);
+        CHECK(context.from_montgomery(context.one()) == uint_t<256>{1});
+        CHECK(context.mont_mul(context.to_montgomery(a), context.one()) == context.to_montgomery(a));
+    }
+
+    TEST_CASE("curve25519 field, bits not a multiple of the word") {
+        const auto p = from_hex<255>("7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed");
+        const Montgomery<255> context{p};
+        const auto a = from_hex<255>("bfcf73725ed09d3a0562d56abd685a48f165d57b00c7f4781ef86f5c8cc1ab");
+        const auto b = from_hex<255>("1c7896c9a28f17d83ce44e27424458b6b6043106a85f68b6daa8b2a668d605d4");
+        CHECK(multiply_modulo(context, a, b) ==
+              from_hex<255>("1b66e8bd34f91ae0323ddef32a11d98382774aeb5686f8764b2db7c944cc6d13"));
+        CHECK(context.from_montgomery(context.mont_sqr(context.to_montgomery(a))) ==
+              from_hex<255>("158383ec66675a3c07d8eb9551e3f293042e144e3aa8997081c93df2fb9c58a6"));
+    }
+
+    TEST_CASE("512 bit modulus") {
+        const Montgomery<512> context{from_hex<512>(
+            "9a508bb1f4c9da653868e6d9ca0bc36c05adb3fc4f6341279a23bef7be506564"
+            "f3a160712456de76aaadd6b855c6b62bd09e04924d52bc614bedce030297c5e5")};
+        const auto a = from_hex<512>("61f496dd570b974b7bb26f8fd666d7b79395e1ab258cd357dcd4bb6c48b1481d"
+                                     "ade4f495868519baf078216778fa934256cbe495976c5902b94960f13e4dff39");
+        const auto b = from_hex<512>("900977a9f2c943862c199bd3a49d1ce2844948a86c51ce927e89f91859082551"
+                                     "1600314ac9aee9cf6b978d7d421bb1235c9dc8b64f4e68e5c85bd78d396e0d55");
+        CHECK(multiply_modulo(context, a, b) ==
+              from_hex<512>("31604ac5f61b858731a0cf5a891dbf31d5cdd3f51287ddf44061231e5f3e38ec"
+                            "e1381cfa6995dbc0561fc63f33d4fe2d31856d3f3d6fa382b55f6507dce40f92"));
+        CHECK(context.from_montgomery(context.mont_sqr(context.to_montgomery(a))) ==
+              from_hex<512>("97b8933990c6b182a9ea3f251e36819e308d7d2e2582c50e662f5033b4d34d59"
+                            "12b8639b45807265ed1f87436b35c23f7ee5c3e6f53f2400d9bb428d831265c2"));
+    }
+
+    TEST_CASE("largest operands") {
+        // n = 2^128 - 1 is odd, (n - 1)^2 = 1 mod n and the intermediate results reach 2n
+        const auto n = from_hex<128>("ffffffffffffffffffffffffffffffff");
+        const Montgomery<128> context{n};
+        const auto a = n - 1;
+        CHECK(multiply_modulo(context, a, a) == uint_t<128>{1});
+        CHECK(context.from_montgomery(context.mont_sqr(context.to_montgomery(a))) == uint_t<128>{1});
+    }
+}
+} // namespace understanding_crypto
@@ -0,0 +1,69 @@
+#ifndef UNDERSTANDING_CRYPTO_TEST_NUMBERS_H
+#define UNDERSTANDING_CRYPTO_TEST_NUMBERS_H
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <string_view>
+
+#include <understanding_crypto/biginteger.hpp>
+
+// operands shared by the tests of the big integer family
+namespace understanding_crypto::test {
+// every word random, the top word trimmed to BITS
+template <size_t BITS> uint_t<BITS> random_operand(std::mt19937_64 &random) {
+    uint_t<BITS> result{0};
+    for (size_t i = 0; i < result.word_count; ++i) {
+        result[i] = random();
+    }
+    result.trim();
+    return result;
+}
+
+// a third of the words all ones, for long carry chains
+template <size_t BITS> uint_t<BITS> random_carry_operand(std::mt19937_64 &random) {
+    uint_t<BITS> result{0};
+    for (auto &word : result.internal_main) {
+        word = random() % 3 == 0 ? ~size_t(0) : random();
+    }
+    result.trim();
+    return result;
+}
+
+// words that provoke the corrections of Algorithm D: all ones, only the top bit, zero runs
+template <size_t BITS> uint_t<BITS> random_edge_operand(std::mt19937_64 &random) {
+    uint_t<BITS> result{0};
+    const auto length = 1 + random() % result.word_count;
+    for (size_t i = 0; i < length; ++i) {
+        switch (random() % 4) {
+        case 0: result.internal_main[i] = ~size_t(0); break;
+        case 1: result.internal_main[i] = size_t(1) << (result.bits_in_word - 1); break;
+        case 2: result.internal_main[i] = 0; break;
+        default: result.internal_main[i] = random(); break;
+        }
+    }
+    return result;
+}
+
+template <size_t BITS> uint_t<BITS> random_below(std::mt19937_64 &random, const uint_t<BITS> &n) {
+    uint_t<BITS> result{0};
+    for (auto &word : result.internal_main) {
+        word = random();
+    }
+    return result % n;
+}
+
+// lowercase digits, most significant first
+template <size_t BITS> uint_t<BITS> from_hex(std::string_view hex) {
+    uint_t<BITS> result{0};
+    auto bit = 0U;
+    for (auto i = hex.size(); i-- > 0; bit += 4) {
+        const auto c = hex[i];
+        const size_t digit = c <= '9' ? c - '0' : c - 'a' + 10;
+        result.internal_main[bit / result.bits_in_word] |= digit << (bit % result.bits_in_word);
+    }
+    return result;
+}
+} // namespace understanding_crypto::test
+
+#endif
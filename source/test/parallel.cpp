@@ -0,0 +1,113 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/parallel.hpp>
+
+#include <vector>
+
+namespace understanding_crypto::aes {
+
+namespace {
+std::array<uint8_t, 32> key = {0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae,
+                               0xf0, 0x85, 0x7d, 0x77, 0x81, 0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61,
+                               0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4};
+const std::array<uint8_t, 16> iv = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                    0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+
+// many small chunks, so every thread gets several and the last one is partial
+constexpr size_t chunk_size = 1024;
+
+std::vector<uint8_t> message(size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (auto i = 0U; i < bytes.size(); ++i) {
+        bytes[i] = i * 31 + 7;
+    }
+    return bytes;
+}
+} // namespace
+
+TEST_SUITE("thread pool") {
+    TEST_CASE("runs every index once") {
+        Thread_Pool pool{4};
+        std::vector<std::atomic<int>> calls(1000);
+        for (auto round = 0; round < 3; ++round) {
+            pool.for_each(calls.size(), [&](size_t i) { ++calls[i]; });
+        }
+        CHECK(std::all_of(calls.begin(), calls.end(), [](const auto &count) { return count == 3; }));
+    }
+}
+
+TEST_SUITE("matches single threaded") {
+    TEST_CASE("ecb") {
+        const auto expanded = AES::Common::expand_key(key256_t{key});
+        const auto plain = message(37 * chunk_size + 16 * 5);
+        auto expected = plain;
+        AES::encrypt_blocks(std::span(expected), expanded);
+
+        Parallel parallel{4, chunk_size};
+        auto actual = plain;
+        parallel.ecb_encrypt(actual, expanded);
+        CHECK(actual == expected);
+        parallel.ecb_decrypt(actual, expanded);
+        CHECK(actual == plain);
+    }
+
+    TEST_CASE("ctr") {
+        const auto expanded = AES::Common::expand_key(key256_t{key});
+        const auto plain = message(37 * chunk_size + 11);
+        std::vector<uint8_t> expected(plain.size());
+        CTR{expanded, iv}.process(plain, expected);
+
+        Parallel parallel{4, chunk_size};
+        auto actual = plain;
+        parallel.ctr(expanded, iv, actual, actual);
+        CHECK(actual == expected);
+    }
+
+    TEST_CASE("cbc decrypt") {
+        const auto schedule = AES::Common::expand_key_schedule(key256_t{key});
+        const auto plain = message(37 * chunk_size + 16 * 5);
+        // C_i = E(P_i ^ C_i-1)
+        auto cipher = plain;
+        std::array<uint8_t, 16> chain = iv;
+        for (auto offset = 0U; offset < cipher.size(); offset += 16) {
+            const block128_t block{&cipher[offset], 16};
+            for (auto i = 0U; i < 16; ++i) {
+                block[i] ^= chain[i];
+            }
+            AES::encrypt(block, schedule);
+            std::copy_n(block.begin(), 16, chain.begin());
+        }
+
+        Parallel parallel{4, chunk_size};
+        std::vector<uint8_t> actual(cipher.size());
+        parallel.cbc_decrypt(schedule, iv, cipher, actual);
+        CHECK(actual == plain);
+        parallel.cbc_decrypt(schedule, iv, cipher, cipher);
+        CHECK(cipher == plain);
+    }
+
+    TEST_CASE("gcm") {
+        const auto expanded = AES::Common::expand_key_schedule(key256_t{key});
+        const GCM gcm{expanded};
+        const auto nonce = std::span(iv).first<12>();
+        const auto aad = message(45);
+        const auto plain = message(37 * chunk_size + 11);
+
+        std::vector<uint8_t> expected(plain.size());
+        std::array<uint8_t, 16> expected_tag;
+        gcm.encrypt(nonce, aad, plain, expected, expected_tag);
+
+        Parallel parallel{4, chunk_size};
+        std::vector<uint8_t> actual(plain.size());
+        std::array<uint8_t, 16> tag;
+        parallel.gcm_encrypt(gcm, nonce, aad, plain, actual, tag);
+        CHECK(actual == expected);
+        CHECK(tag == expected_tag);
+
+        std::vector<uint8_t> decrypted(actual.size());
+        CHECK(parallel.gcm_decrypt(gcm, nonce, aad, actual, decrypted, tag));
+        CHECK(decrypted == plain);
+        tag[0] ^= 1;
+        CHECK_FALSE(parallel.gcm_decrypt(gcm, nonce, aad, actual, decrypted, tag));
+    }
+}
+} // namespace understanding_crypto::aes
@@ -0,0 +1,178 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/sha.hpp>
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace understanding_crypto::sha {
+namespace {
+std::span<const uint8_t> as_bytes(std::string_view text) {
+    return {reinterpret_cast<const uint8_t *>(text.data()), text.size()};
+}
+
+template <size_t N> std::array<uint8_t, N> from_hex(std::string_view hex) {
+    std::array<uint8_t, N> result;
+    const auto digit = [](char c) { return c <= '9' ? c - '0' : c - 'a' + 10; };
+    for (size_t i = 0; i < N; ++i) {
+        result[i] = uint8_t(digit(hex[2 * i]) << 4 | digit(hex[2 * i + 1]));
+    }
+    return result;
+}
+
+// messages of every length up to a few blocks and some longer ones, in random order
+std::vector<std::vector<uint8_t>> random_messages(size_t count) {
+    std::mt19937_64 random(count);
+    std::vector<std::vector<uint8_t>> messages(count);
+    for (auto &message : messages) {
+        message.resize(random() % 8 == 0 ? random() % 2000 : random() % (3 * block_size));
+        for (auto &byte : message) {
+            byte = uint8_t(random());
+        }
+    }
+    return messages;
+}
+
+template <typename engine_t> void check_lanes() {
+    for (const auto count : {size_t(0), size_t(1), engine_t::lanes - 1, size_t(200)}) {
+        const auto data = random_messages(count);
+        const std::vector<std::span<const uint8_t>> messages(data.begin(), data.end());
+        std::vector<SHA256::digest_t> digests(count);
+        hash_lanes<engine_t>(messages, digests);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(digests[i] == SHA256::hash(messages[i]));
+        }
+    }
+}
+
+// FIPS 180-2 appendix B and the NIST example vectors
+constexpr std::string_view one_block = "abc";
+constexpr std::string_view two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+template <typename engine_t> void check_engine() {
+    std::mt19937_64 random(256);
+    std::vector<uint8_t> data(block_size * 20);
+    for (auto &byte : data) {
+        byte = uint8_t(random());
+    }
+    for (size_t blocks = 0; blocks <= 20; ++blocks) {
+        state_t expected = SHA256::initial_state, state = SHA256::initial_state;
+        Reference::compress(expected, std::span(data).first(blocks * block_size));
+        engine_t::compress(state, std::span(data).first(blocks * block_size));
+        CHECK(state == expected);
+    }
+}
+} // namespace
+
+TEST_SUITE("sha-256") {
+    TEST_CASE("nist vectors") {
+        CHECK(SHA256::hash({}) ==
+              from_hex<32>("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+        CHECK(SHA256::hash(as_bytes(one_block)) ==
+              from_hex<32>("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+        CHECK(SHA256::hash(as_bytes(two_blocks)) ==
+              from_hex<32>("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+    }
+
+    TEST_CASE("one million a") {
+        const std::vector<uint8_t> chunk(1000, 'a');
+        SHA256 hasher;
+        for (auto i = 0; i < 1000; ++i) {
+            hasher.update(chunk);
+        }
+        CHECK(hasher.finalize() ==
+              from_hex<32>("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+    }
+
+    TEST_CASE("incremental updates at every split") {
+        std::vector<uint8_t> data(3 * block_size + 5);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = uint8_t(i * 7);
+        }
+        for (size_t length = 0; length <= data.size(); ++length) {
+            const auto message = std::span<const uint8_t>(data).first(length);
+            const auto expected = SHA256::hash(message);
+            for (size_t split = 0; split <= length; split += 3) {
+                SHA256 hasher;
+                hasher.update(message.first(split));
+                hasher.update(message.subspan(split));
+                CHECK(hasher.finalize() == expected);
+            }
+        }
+    }
+
+    TEST_CASE("finalize starts a new message") {
+        SHA256 hasher;
+        hasher.update(as_bytes(two_blocks));
+        hasher.finalize();
+        hasher.update(as_bytes(one_block));
+        CHECK(hasher.finalize() == SHA256::hash(as_bytes(one_block)));
+    }
+
+    TEST_CASE("reference") { check_engine<Reference>(); }
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+    TEST_CASE("sha-ni") {
+        if (SHANI::supported()) {
+            check_engine<SHANI>();
+        }
+    }
+#endif
+}
+
+TEST_SUITE("sha-256 multi-buffer") {
+    TEST_CASE("hash_batch") {
+        for (const auto count : {size_t(0), size_t(3), size_t(16), size_t(333)}) {
+            const auto data = random_messages(count);
+            const std::vector<std::span<const uint8_t>> messages(data.begin(), data.end());
+            std::vector<SHA256::digest_t> digests(count);
+            hash_batch(messages, digests);
+            for (size_t i = 0; i < count; ++i) {
+                CHECK(digests[i] == SHA256::hash(messages[i]));
+            }
+        }
+
+        // the padding of the lanes at the block boundaries
+        std::vector<std::vector<uint8_t>> data;
+        for (size_t length = 0; length <= 3 * block_size; ++length) {
+            data.emplace_back(length, uint8_t(length));
+        }
+        const std::vector<std::span<const uint8_t>> messages(data.begin(), data.end());
+        std::vector<SHA256::digest_t> digests(data.size());
+        hash_batch(messages, digests);
+        for (size_t i = 0; i < data.size(); ++i) {
+            CHECK(digests[i] == SHA256::hash(messages[i]));
+        }
+    }
+
+#ifdef UNDERSTANDING_CRYPTO_X86
+    TEST_CASE("avx2") {
+        if (AVX2::supported()) {
+            check_lanes<AVX2>();
+        }
+    }
+
+    TEST_CASE("avx-512") {
+        if (AVX512::supported()) {
+            check_lanes<AVX512>();
+        }
+    }
+#endif
+}
+
+TEST_SUITE("sha-224") {
+    TEST_CASE("nist vectors") {
+        CHECK(SHA224::hash({}) == from_hex<28>("d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f"));
+        CHECK(SHA224::hash(as_bytes(one_block)) ==
+              from_hex<28>("23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7"));
+        CHECK(SHA224::hash(as_bytes(two_blocks)) ==
+              from_hex<28>("75388b16512776cc5dba5da1fd890150b0c6455cb4f58b1952522525"));
+    }
+
+    TEST_CASE("one million a") {
+        const std::vector<uint8_t> message(1000000, 'a');
+        CHECK(SHA224::hash(message) ==
+              from_hex<28>("20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67"));
+    }
+}
+} // namespace understanding_crypto::sha
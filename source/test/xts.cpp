@@ -0,0 +1,141 @@
+#include <doctest/doctest.h>
+#include <understanding_crypto/xts.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace understanding_crypto::aes {
+
+namespace {
+std::vector<uint8_t> message(size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (auto i = 0U; i < bytes.size(); ++i) {
+        bytes[i] = i * 31 + 7;
+    }
+    return bytes;
+}
+
+// the mode references the expanded keys, a temporary would dangle
+using expanded_t = decltype(AES::Common::expand_key(std::declval<key128_t>()));
+static_assert(!std::is_constructible_v<XTS<expanded_t>, expanded_t, const expanded_t &>);
+static_assert(!std::is_constructible_v<XTS<expanded_t>, const expanded_t &, expanded_t>);
+static_assert(std::is_constructible_v<XTS<expanded_t>, const expanded_t &, const expanded_t &>);
+} // namespace
+
+TEST_SUITE("examples") {
+    // IEEE 1619 vector 2, vector 1 uses the same key twice
+    TEST_CASE("repeated keys") {
+        std::array<uint8_t, 16> data_key, tweak_key;
+        data_key.fill(0x11);
+        tweak_key.fill(0x22);
+        const auto data_keys = AES::Common::expand_key(key128_t{data_key});
+        const auto tweak_keys = AES::Common::expand_key(key128_t{tweak_key});
+        const XTS xts{data_keys, tweak_keys};
+        const std::array<uint8_t, 32> expected = {
+            0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e, 0x39, 0x33, 0x40, 0x38, 0xac, 0xef, 0x83, 0x8b,
+            0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80, 0xad, 0xc4, 0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0};
+
+        std::array<uint8_t, 32> data;
+        data.fill(0x44);
+        xts.encrypt_sector(0x3333333333, data, data);
+        CHECK_EQ(data, expected);
+        xts.decrypt_sector(0x3333333333, data, data);
+        CHECK(std::all_of(data.begin(), data.end(), [](uint8_t byte) { return byte == 0x44; }));
+    }
+
+    // IEEE 1619 vectors 15 to 18, ciphertext stealing
+    TEST_CASE("partial last block") {
+        std::array<uint8_t, 16> data_key = {0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8,
+                                            0xf7, 0xf6, 0xf5, 0xf4, 0xf3, 0xf2, 0xf1, 0xf0};
+        std::array<uint8_t, 16> tweak_key = {0xbf, 0xbe, 0xbd, 0xbc, 0xbb, 0xba, 0xb9, 0xb8,
+                                             0xb7, 0xb6, 0xb5, 0xb4, 0xb3, 0xb2, 0xb1, 0xb0};
+        const auto data_keys = AES::Common::expand_key_schedule(key128_t{data_key});
+        const auto tweak_keys = AES::Common::expand_key(key128_t{tweak_key});
+        const XTS xts{data_keys, tweak_keys};
+        const std::array<uint8_t, 20> expected = {0x9d, 0x84, 0xc8, 0x13, 0xf7, 0x19, 0xaa, 0x2c, 0x7b, 0xe3,
+                                                  0xf6, 0x61, 0x71, 0xc7, 0xc5, 0xc2, 0xed, 0xbf, 0x9d, 0xac};
+        // the first 17 bytes of vectors 15, 16 and 17
+        const std::array<std::array<uint8_t, 17>, 3> shorter = {{
+            {0x6c, 0x16, 0x25, 0xdb, 0x46, 0x71, 0x52, 0x2d, 0x3d, 0x75, 0x99, 0x60, 0x1d, 0xe7, 0xca, 0x09,
+             0xed},
+            {0xd0, 0x69, 0x44, 0x4b, 0x7a, 0x7e, 0x0c, 0xab, 0x09, 0xe2, 0x44, 0x47, 0xd2, 0x4d, 0xeb, 0x1f,
+             0xed},
+            {0xe5, 0xdf, 0x13, 0x51, 0xc0, 0x54, 0x4b, 0xa1, 0x35, 0x0b, 0x33, 0x63, 0xcd, 0x8e, 0xf4, 0xbe,
+             0xed},
+        }};
+
+        std::array<uint8_t, 20> plain;
+        for (auto i = 0U; i < plain.size(); ++i) {
+            plain[i] = i;
+        }
+        std::array<uint8_t, 20> cipher;
+        for (auto size = 17U; size <= 20; ++size) {
+            xts.encrypt_sector(0x123456789a, std::span(plain).first(size), cipher);
+            if (size == 20) {
+                CHECK_EQ(cipher, expected);
+            } else {
+                const auto prefix = std::span(shorter[size - 17]);
+                CHECK(std::equal(prefix.begin(), prefix.end(), cipher.begin()));
+            }
+
+            std::array<uint8_t, 20> decrypted{};
+            xts.decrypt_sector(0x123456789a, std::span(cipher).first(size), decrypted);
+            CHECK(std::equal(decrypted.begin(), decrypted.begin() + size, plain.begin()));
+        }
+    }
+}
+
+TEST_SUITE("sectors") {
+    TEST_CASE("invalid input") {
+        std::array<uint8_t, 16> key{};
+        const auto keys = AES::Common::expand_key(key128_t{key});
+        CHECK_THROWS_AS((XTS{keys, keys}), std::invalid_argument);
+
+        key[0] = 1;
+        const auto tweak_keys = AES::Common::expand_key(key128_t{key});
+        const XTS xts{keys, tweak_keys};
+        std::vector<uint8_t> data(2 * 16 + 7);
+        for (auto size = 1U; size < 16; ++size) {
+            CHECK_THROWS_AS(xts.encrypt_sector(0, std::span(data).first(size), data), std::invalid_argument);
+            CHECK_THROWS_AS(xts.decrypt_sector(0, std::span(data).first(size), data), std::invalid_argument);
+        }
+        // the short sector is the last of the run
+        CHECK_THROWS_AS(xts.encrypt_sectors(0, 16, data, data), std::invalid_argument);
+        CHECK_NOTHROW(xts.encrypt_sectors(0, 23, data, data));
+        CHECK_NOTHROW(xts.encrypt_sector(0, {}, {}));
+    }
+
+    TEST_CASE("tweak multiplication carries") {
+        XTS<key_schedule_t<11>>::tweak_t tweak{0x8000000000000000, 0x8000000000000000};
+        tweak.next();
+        CHECK_EQ(tweak.low, 0x87);
+        CHECK_EQ(tweak.high, 1);
+    }
+
+    TEST_CASE("in place across batches") {
+        std::array<uint8_t, 32> key{};
+        key[0] = 1;
+        const auto data_keys = AES::Common::expand_key_schedule(key128_t{std::span(key).first<16>()});
+        const auto tweak_keys = AES::Common::expand_key(key128_t{std::span(key).last<16>()});
+        const XTS xts{data_keys, tweak_keys};
+        // two sectors longer than one tweak batch, then a short one with a partial block
+        constexpr size_t sector_size = 4096 + 512;
+        const auto plain = message(2 * sector_size + 100);
+
+        std::vector<uint8_t> expected(plain.size());
+        for (auto sector = 0U; sector < 3; ++sector) {
+            const auto offset = sector * sector_size;
+            const auto size = std::min(sector_size, plain.size() - offset);
+            xts.encrypt_sector(7 + sector, std::span(plain).subspan(offset, size),
+                               std::span(expected).subspan(offset, size));
+        }
+
+        auto data = plain;
+        xts.encrypt_sectors(7, sector_size, data, data);
+        CHECK(data == expected);
+        xts.decrypt_sectors(7, sector_size, data, data);
+        CHECK(data == plain);
+    }
+}
+} // namespace understanding_crypto::aes
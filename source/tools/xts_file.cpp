@@ -0,0 +1,167 @@
+// encrypts or decrypts a file with XTS-AES in 4 KiB sectors, sector n starts at byte n * 4096
+//   xts_file encrypt|decrypt <key hex> <input> [output]
+// the key is the data key followed by the tweak key, 32 bytes for AES-128 and 64 for AES-256. Without an
+// output file the input is changed in place. Both files are mapped, the sectors are processed in parallel.
+#include <understanding_crypto/context.hpp>
+#include <understanding_crypto/thread_pool.hpp>
+#include <understanding_crypto/xts.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace understanding_crypto;
+using namespace understanding_crypto::aes;
+
+namespace {
+constexpr size_t sector_size = 4096;
+// sectors per task of the thread pool
+constexpr size_t sectors_per_task = 64;
+
+// zeroed on every return from main
+struct Key_Bytes {
+    std::vector<uint8_t> bytes;
+    ~Key_Bytes() { secure_zero(bytes.data(), bytes.size()); }
+};
+
+// reserved up front, so no copy of the key is left behind by a reallocation
+bool parse_hex(std::string_view hex, std::vector<uint8_t> &bytes) {
+    const auto digit = [](char c) -> int {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    };
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    bytes.reserve(hex.size() / 2);
+    for (auto i = 0U; i < hex.size(); i += 2) {
+        const auto high = digit(hex[i]);
+        const auto low = digit(hex[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes.push_back(high << 4 | low);
+    }
+    return true;
+}
+
+// read only for a separate output, MAP_FAILED on error
+uint8_t *map(int file, size_t size, bool writable) {
+    const auto protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    const auto address = mmap(nullptr, size, protection, MAP_SHARED, file, 0);
+    if (address != MAP_FAILED) {
+        madvise(address, size, MADV_SEQUENTIAL);
+    }
+    return static_cast<uint8_t *>(address);
+}
+
+template <typename key_t>
+void run(bool encrypting, std::span<uint8_t> key, std::span<const uint8_t> input, std::span<uint8_t> output) {
+    // the contexts zero their schedules when run returns
+    const Context data_keys{key_t{key.first<key_t::extent>()}};
+    const Context tweak_keys{key_t{key.last<key_t::extent>()}};
+    const XTS xts{data_keys.keys(), tweak_keys.keys()};
+
+    constexpr auto task_size = sector_size * sectors_per_task;
+    Thread_Pool pool;
+    pool.for_each((input.size() + task_size - 1) / task_size, [&](size_t task) {
+        const auto offset = task * task_size;
+        const auto size = std::min(task_size, input.size() - offset);
+        const auto sector = offset / sector_size;
+        const auto source = input.subspan(offset, size);
+        const auto target = output.subspan(offset, size);
+        if (encrypting) {
+            xts.encrypt_sectors(sector, sector_size, source, target);
+        } else {
+            xts.decrypt_sectors(sector, sector_size, source, target);
+        }
+    });
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 4 && argc != 5) {
+        std::fprintf(stderr, "usage: %s encrypt|decrypt <key hex> <input> [output]\n", argv[0]);
+        return 1;
+    }
+    const std::string_view mode = argv[1];
+    if (mode != "encrypt" && mode != "decrypt") {
+        std::fprintf(stderr, "unknown mode %s\n", argv[1]);
+        return 1;
+    }
+    Key_Bytes key;
+    if (!parse_hex(argv[2], key.bytes) ||
+        (key.bytes.size() != 2 * key128_t::extent && key.bytes.size() != 2 * key256_t::extent)) {
+        std::fprintf(stderr, "the key has to be 64 or 128 hex digits\n");
+        return 1;
+    }
+    // checked before the output file is truncated
+    const auto half = key.bytes.size() / 2;
+    if (std::equal(key.bytes.begin(), key.bytes.begin() + half, key.bytes.begin() + half)) {
+        std::fprintf(stderr, "the data key and the tweak key have to differ\n");
+        return 1;
+    }
+
+    const auto in_place = argc == 4;
+    const auto input_file = open(argv[3], in_place ? O_RDWR : O_RDONLY);
+    struct stat status;
+    if (input_file < 0 || fstat(input_file, &status) != 0) {
+        std::perror(argv[3]);
+        return 1;
+    }
+    const auto size = size_t(status.st_size);
+    // every sector needs one whole block, including a short last one
+    if (size % sector_size != 0 && size % sector_size < XTS<key_schedule_t<11>>::block_size) {
+        std::fprintf(stderr, "the last sector of %s is shorter than one block\n", argv[3]);
+        return 1;
+    }
+
+    auto output_file = input_file;
+    if (!in_place) {
+        output_file = open(argv[4], O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (output_file < 0 || ftruncate(output_file, status.st_size) != 0) {
+            std::perror(argv[4]);
+            return 1;
+        }
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    const auto input = map(input_file, size, in_place);
+    const auto output = in_place ? input : map(output_file, size, true);
+    if (input == MAP_FAILED || output == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto encrypting = mode == "encrypt";
+    if (key.bytes.size() == 2 * key128_t::extent) {
+        run<key128_t>(encrypting, key.bytes, {input, size}, {output, size});
+    } else {
+        run<key256_t>(encrypting, key.bytes, {input, size}, {output, size});
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s %zu bytes in %.3f s, %.1f MB/s\n", argv[1], size, seconds, size / seconds / 1e6);
+
+    munmap(input, size);
+    if (!in_place) {
+        munmap(output, size);
+        close(output_file);
+    }
+    close(input_file);
+    return 0;
+}